@@ -0,0 +1,87 @@
+/*
+**	Command & Conquer Red Alert(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Command & Conquer                                            *
+ *                                                                                             *
+ *                    File Name : BACKREF.H                                                    *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef BACKREF_H
+#define BACKREF_H
+
+/*
+**	This records, for every target value, which game objects might be holding on to it in
+**	their targeting computer, navigation computer, radio, or similar tracking fields. When an
+**	object leaves the game, only those holders need to be told about it rather than every
+**	object in every heap. A holder is recorded whenever one of these fields is assigned. The
+**	record is never removed at that time, so the list for a target is always a superset of
+**	the real holders. Stale records are harmless and are discarded when the table fills up
+**	and is rebuilt from the objects themselves.
+*/
+class BackRefClass
+{
+	public:
+		BackRefClass(void);
+
+		void Clear(void);
+		void Recalc(void);
+		void Add(TARGET target, ObjectClass * holder);
+		bool Detach(TARGET target, bool all);
+
+	private:
+		enum {
+			HASH_SIZE=4096,				// Must be a power of two.
+			ENTRY_MAX=16384,				// Maximum number of holder records.
+			HOLDER_MAX=256					// Maximum holders notified in one detach.
+		};
+
+		/*
+		**	Each record ties one holder to one target. Records that hash to the same
+		**	bucket are chained together.
+		*/
+		typedef struct {
+			TARGET Target;
+			ObjectClass * Holder;
+			short Next;
+		} EntryType;
+
+		static int Hash(TARGET target) {return((int)(((unsigned long)target ^ ((unsigned long)target >> 12) ^ ((unsigned long)target >> 24)) & (HASH_SIZE-1)));};
+		static bool References(ObjectClass const * holder, TARGET target);
+		void Add_References(ObjectClass * holder);
+		void Remove(int bucket, short index, short prev);
+
+		short Bucket[HASH_SIZE];
+		EntryType Entries[ENTRY_MAX];
+		short FreeList;
+
+		/*
+		**	If the table could not hold every reference even after being rebuilt, then
+		**	this flag is set and detaching falls back to sweeping every object.
+		*/
+		bool IsOverflow;
+};
+
+
+#endif
@@ -29,7 +29,7 @@
  *                                                                                             *
  *                   Start Date : 07/17/96                                                     *
  *                                                                                             *
- *                  Last Update : July 17, 1996 [JLB]                                          *
+ *                  Last Update : October 17, 2026                                             *
  *                                                                                             *
  *---------------------------------------------------------------------------------------------*
  * Functions:                                                                                  *
@@ -39,75 +39,165 @@
 #ifndef BENCH_H
 #define BENCH_H
 
-#include	"mpu.h"
-#include	"ftimer.h"
+#include	<stdio.h>
+#ifndef WIN32
+#include	<pthread.h>
+#endif
+
 
 /*
-**	The "bool" integral type was defined by the C++ committee in
-**	November of '94. Until the compiler supports this, use the following
-**	definition.
-*/
-/*
-**	This is a timer access object that will fetch the internal Pentium
-**	clock value.
+**	This is the performance profiler. Code to be measured is bracketed with BStart() and
+**	BEnd() (or covered by a BZone() for a whole scope) using the BenchType identifiers.
+**	Zones nest, so each one records both its total time and its self time (the total
+**	less the time of the zones opened inside it). Every thread keeps its own zone stack
+**	and accumulators; the main thread gathers them once per game frame into a history
+**	of per-frame times from which the percentiles are taken. Without pthreads, only the
+**	main thread is profiled. When a trace file is given, every zone is also written out
+**	as a Chrome trace event for chrome://tracing or ui.perfetto.dev.
+**
+**	The macros test IsEnabled before calling in, so a disabled profiler costs one test.
 */
-class PentiumTimerClass
+class ProfilerClass
 {
 	public:
-		unsigned long operator () (void) const {unsigned long h;unsigned long l = Get_CPU_Clock(h);return((l >> 4) | (h << 28));}
-		operator unsigned long (void) const {unsigned long h;unsigned long l = Get_CPU_Clock(h);return((l >> 4) | (h << 28));}
-};
+		ProfilerClass(void);
+		~ProfilerClass(void);
 
+		void Enable(char const * tracename=NULL, int period=0);
+		void Shutdown(void);
 
-/*
-**	A performance tracking tool object. It is used to track elapsed time. Unlike a simple clock, this
-**	class will keep a running average of the duration. Typical use of this would be to benchmark some
-**	process that occurs multiple times. By benchmarking an average time, inconsistencies in a particular
-**	run can be overcome.
-*/
-class Benchmark
-{
-	public:
-		Benchmark(void);
+		void Begin(BenchType zone);
+		void End(BenchType zone);
+		void Count(ProfileCountType counter);
+		void Frame(void);
+		void Summary(FILE * out) const;
 
-		void Begin(bool reset=false);
-		void End(void);
+		unsigned long Total(BenchType zone) const;
+		unsigned long Calls(BenchType zone) const;
+		unsigned long Average(BenchType zone) const;
+		long Take_Count(ProfileCountType counter);
 
-		void Reset(void);
-		unsigned long Value(void) const;
-		unsigned long Count(void) const {return(TotalCount);}
+		/*
+		**	Set while the profiler is gathering data.
+		*/
+		bool IsEnabled;
 
 	private:
+		enum {
+			HISTORY=512,			// Number of frames kept for the percentile calculations.
+			MAX_DEPTH=32,			// Deepest zone nesting tracked on any one thread.
+			TRACE_EVENTS=16384	// Trace events a thread can buffer between frames.
+		};
+
 		/*
-		**	The maximum number of events to keep running average of. If
-		**	events exceed this number, then older events drop off the
-		**	accumulated time. This number needs to be as small as
-		**	is reasonable. The larger this number gets, the less magnitude
-		**	that the benchmark timer can handle. Example; At a value of
-		**	256, the magnitude of the timer can only be 24 bits.
+		**	One finished zone, waiting to be written to the trace file.
 		*/
-		enum {MAXIMUM_EVENT_COUNT=256};
+		typedef struct {
+			BenchType Zone;
+			unsigned long long Start;
+			unsigned long long Length;
+		} EventType;
 
 		/*
-		**	This is the timer the is used to clock the events.
+		**	The profiling state of one thread. The zone stack is only ever touched by its
+		**	own thread. The accumulators and event buffer are shared with the main thread
+		**	(which empties them every frame) and so are guarded by the lock. The retired
+		**	flag is guarded by the owner's thread list lock instead.
 		*/
-		BasicTimerClass<PentiumTimerClass> Clock;
+		typedef struct ThreadType {
+			struct ThreadType * Next;
+			ProfilerClass * Owner;
+			int ID;
+			bool IsNamed;
+			bool IsRetired;
+			#ifndef WIN32
+			pthread_mutex_t Lock;
+			#endif
+
+			int Depth;
+			struct {
+				BenchType Zone;
+				unsigned long long Start;
+				unsigned long long Child;
+			} Stack[MAX_DEPTH];
+
+			unsigned long long Time[BENCH_COUNT];
+			unsigned long long Self[BENCH_COUNT];
+			unsigned long Calls[BENCH_COUNT];
+			BenchType Parent[BENCH_COUNT];
+			unsigned long Counts[COUNT_COUNT];
+
+			EventType * Events;
+			int EventCount;
+			long Dropped;
+		} ThreadType;
+
+		ThreadType * Thread(void);
+		void Gather(ThreadType * thread);
+		void Print_Zone(FILE * out, BenchType zone, int depth, int frames, bool * printed) const;
+		static unsigned long long Clock(void);
+		#ifndef WIN32
+		static void Retire(void * thread);
+		#endif
 
 		/*
-		**	The total time off all events tracked so far.
+		**	Per-frame history, in microseconds for the zones. Each array is a ring that
+		**	is indexed by the frame number modulo HISTORY.
 		*/
-		unsigned long Average;
+		unsigned long History[BENCH_COUNT][HISTORY];
+		unsigned long SelfHistory[BENCH_COUNT][HISTORY];
+		unsigned long CallHistory[BENCH_COUNT][HISTORY];
+		unsigned long CountHistory[COUNT_COUNT][HISTORY];
 
 		/*
-		**	The total number of events tracked so far.
+		**	Totals for the whole run. The rules and scenario zones happen once, long
+		**	before the history has anything in it, so these are the only record of them.
 		*/
-		unsigned long Counter;
+		unsigned long long RunTime[BENCH_COUNT];
+		unsigned long RunCalls[BENCH_COUNT];
+		long RunCounts[COUNT_COUNT];
+		long TakenCounts[COUNT_COUNT];
 
 		/*
-		**	Absolute total number of events (possibly greater than the
-		**	number of events tracked in the average).
+		**	The zone each zone was last seen nested inside. The summary uses this to
+		**	print the zones as a tree.
+		*/
+		BenchType Parent[BENCH_COUNT];
+
+		long Frames;
+		int Period;
+		long Dropped;
+
+		FILE * Trace;
+		long TraceCount;
+		unsigned long long Epoch;
+
+		ThreadType * Threads;
+		int NextID;
+		#ifndef WIN32
+		pthread_mutex_t Lock;
+		pthread_key_t Key;
+		#else
+		/*
+		**	Without pthreads only the main thread is profiled, and this is its data.
 		*/
-		unsigned long TotalCount;
+		ThreadType * MainThread;
+		#endif
+};
+
+
+/*
+**	Profiles the scope it is declared in. Use it through the BZone() macro.
+*/
+class ProfileZoneClass
+{
+	public:
+		ProfileZoneClass(BenchType zone);
+		~ProfileZoneClass(void);
+
+	private:
+		BenchType Zone;
+		bool IsActive;
 };
 
 
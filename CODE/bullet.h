@@ -94,7 +94,7 @@ class BulletClass :	public ObjectClass,
 		int Shape_Number(void) const;
 		virtual LayerType In_Which_Layer(void) const;
 		virtual COORDINATE Sort_Y(void) const;
-		virtual void Assign_Target(TARGET target) {TarCom = target;};
+		virtual void Assign_Target(TARGET target);
 		virtual bool Unlimbo(COORDINATE , DirType facing = DIR_N);
 		virtual ObjectTypeClass const & Class_Of(void) const {return *Class;};
 		virtual void Detach(TARGET target, bool all);
@@ -119,6 +119,8 @@ class BulletClass :	public ObjectClass,
 		*/
 		unsigned IsInaccurate:1;
 
+		friend class BackRefClass;
+
 	private:
 		// Crude animation flag.
 		unsigned IsToAnimate:1;
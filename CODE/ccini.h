@@ -56,6 +56,7 @@ class CCINIClass : public INIClass
 
 		bool Load(FileClass & file, bool withdigest);
 		bool Load(Straw & file, bool withdigest);
+		bool Load_Cached(FileClass & file, FileClass & cache);
 		int Save(FileClass & file, bool withdigest) const;
 		int Save(Pipe & pipe, bool withdigest) const;
 
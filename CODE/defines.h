@@ -63,6 +63,14 @@
 */
 //#define DONGLE
 
+/**********************************************************************
+**	Set this to cross check the incremental caches (such as the movement
+**	zone regions, the back reference table and the house scan bits) against
+**	a full recalculation. The checks are slow, so this is only for tracking
+**	down cache bugs.
+*/
+//#define VERIFY_CACHES
+
 
 // Enable 640x400 VQ movie capability in WIN32 mode
 #define MOVIE640
@@ -2724,6 +2732,7 @@ typedef enum DMonoType {
 **	Performance benchmark tracking identifiers.
 */
 typedef enum BenchType {
+	BENCH_NONE=-1,
 	BENCH_GAME_FRAME,			// Whole game frame (used for normalizing).
 	BENCH_FINDPATH,			// Find path calls.
 	BENCH_GREATEST_THREAT,	// Greatest threat calculation.
@@ -2742,10 +2751,14 @@ typedef enum BenchType {
 	BENCH_SHROUD,				// Shroud layer drawing.
 	BENCH_ANIMS,				// Animations drawing.
 	BENCH_OBJECTS,				// All game object drawing.
+	BENCH_SHAPE_HIT,			// Shape frame found already decoded.
+	BENCH_SHAPE_MISS,			// Shape frame that had to be built.
 	BENCH_PALETTE,				// Color cycling palette adjustments.
 	BENCH_GSCREEN_RENDER,	// Rendering of the whole map layered system (with blits).
 	BENCH_BLIT_DISPLAY,		// DirectX or shadow blit of hidpage to seenpage.
 	BENCH_MISSION,				// Mission list processing.
+	BENCH_SAVE_WRITE,			// Background save game write.
+	BENCH_SAVE_COMPRESS,		// Save game block compression (one per thread).
 
 	BENCH_RULES,				// Processing of the rules.ini file.
 	BENCH_SCENARIO,			// Processing of the scenario.ini file.
@@ -2754,14 +2767,28 @@ typedef enum BenchType {
 	BENCH_FIRST=0
 } BenchType;
 
+/*
+**	Event counters kept by the profiler. These count occurrences per frame rather
+**	than time.
+*/
+typedef enum ProfileCountType {
+	COUNT_FINDPATH,			// Find path calls.
+	COUNT_CELL_REDRAW,		// Cells redrawn.
+	COUNT_TARGET_SCAN,		// Target scans.
+	COUNT_SIDEBAR_REDRAW,	// Sidebar redraws.
 
-#ifdef CHEAT_KEYS
-#define	BStart(a)	if (Benches != NULL) Benches[a].Begin()
-#define	BEnd(a)		if (Benches != NULL) Benches[a].End()
-#else
-#define	BStart(a)
-#define	BEnd(a)
-#endif
+	COUNT_COUNT,
+	COUNT_FIRST=0
+} ProfileCountType;
+
+
+/*
+**	Profiler zones and counters. When the profiler is off, each of these costs one test.
+*/
+#define	BStart(a)	if (Profiler.IsEnabled) Profiler.Begin(a)
+#define	BEnd(a)		if (Profiler.IsEnabled) Profiler.End(a)
+#define	BZone(a)		ProfileZoneClass _bzone(a)
+#define	BCount(a)	if (Profiler.IsEnabled) Profiler.Count(a)
 
 
 /**********************************************************************
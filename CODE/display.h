@@ -183,6 +183,8 @@ class DisplayClass: public MapClass
 		ObjectClass * Next_Object(ObjectClass * object) const;
 		ObjectClass * Prev_Object(ObjectClass * object) const;
 		int Cell_Shadow(CELL cell) const;
+		void Shadow_Edge_Adjust(CELL cell);
+		void Shadow_Edge_Recalc(void);
 		short const * Text_Overlap_List(char const * text, int x, int y) const;
 		bool Is_Spot_Free(COORDINATE coord) const;
 		COORDINATE Closest_Free_Spot(COORDINATE coord, bool any=false) const;
@@ -304,6 +306,13 @@ class DisplayClass: public MapClass
 		static void const *ShadowShapes;
 		static unsigned char ShadowTrans[(SHADOW_COL_COUNT+1)*256];
 
+		/*
+		**	For each cell, this holds a bit for every adjacent cell that is not yet mapped. It
+		**	is the index into the shadow piece table and is kept up to date as cells are mapped
+		**	and shrouded.
+		*/
+		static unsigned char ShadowEdge[MAP_CELL_TOTAL];
+
 		void Redraw_Icons(void);
 		void Redraw_OIcons(void);
 		void Redraw_Shadow(void);
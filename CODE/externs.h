@@ -83,6 +83,8 @@ extern bool Debug_Threat;
 extern bool Debug_Find_Path;
 extern bool Debug_Check_Map;
 extern bool Debug_Playtest;
+extern bool Headless;
+extern long HeadlessFrames;
 
 extern bool Debug_Heap_Dump;
 extern bool Debug_Smart_Print;
@@ -153,9 +155,8 @@ extern CCINIClass					RuleINI;
 #ifdef FIXIT_CSII	//	checked - ajw 9/28/98
 extern CCINIClass					AftermathINI;
 #endif
-extern Benchmark *				Benches;
+extern ProfilerClass				Profiler;
 extern int							MapTriggerID;
-extern int							LogicTriggerID;
 extern PKey							FastKey;
 extern PKey							SlowKey;
 extern RulesClass					Rule;
@@ -186,11 +187,17 @@ extern bool							Brokeout;
 extern GameOptionsClass 		Options;
 
 extern LogicClass 				Logic;
+extern RenderSnapshotClass		RenderSnapshot;
 #ifdef SCENARIO_EDITOR
 extern MapEditClass 				Map;
 #else
 extern MouseClass 				Map;
 #endif
+extern PathGraphClass			PathGraph;
+extern MoveZoneClass			MoveZones;
+extern ThreatGridClass			ThreatGrid;
+extern BackRefClass				BackRefs;
+extern ShapeCacheClass			ShapeCache;
 extern ScoreClass 				Score;
 extern MonoClass 					MonoArray[DMONO_COUNT];
 extern MFCD *						TheaterData;
@@ -250,6 +257,7 @@ extern QueueClass<EventClass, (MAX_EVENTS * 64)>		MirrorList;
 
 extern DynamicVectorClass<ObjectClass *>					CurrentObject;
 extern DynamicVectorClass<TriggerClass *>					LogicTriggers;
+extern TriggerDispatchClass										TriggerDispatch;
 extern DynamicVectorClass<TriggerClass *>					MapTriggers;
 extern DynamicVectorClass<TriggerClass *> 				HouseTriggers[HOUSE_COUNT];
 
@@ -307,10 +315,6 @@ extern bool							PassedProximity;	// used in display.cpp
 extern HousesType					Whom;
 extern _VQAConfig					AnimControl;
 extern long							SpareTicks;
-extern long							PathCount;
-extern long							CellCount;
-extern long							TargetScan;
-extern long							SidebarRedraws;
 extern DMonoType					MonoPage;
 extern bool							GameActive;
 extern bool							SpecialFlag;
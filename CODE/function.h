@@ -117,7 +117,6 @@ struct NoInitClass {
 
 #include "wwlib32/wwlib32.h"
 #include	"mpu.h"
-#include	"bench.h"
 #include	"rect.h"
 #include	"jshell.h"
 #include	"buff.h"
@@ -189,6 +188,7 @@ extern long LParam;
 #include	"debug.h"
 #include "special.h"
 #include	"defines.h"
+#include	"bench.h"
 #include	"ccini.h"
 #include	"ccptr.h"
 #include	"bar.h"
@@ -245,8 +245,14 @@ CELL Coord_Cell(COORDINATE coord);
 #include	"house.h"
 #include	"gscreen.h"
 #include	"map.h"
+#include	"pathgrph.h"
+#include	"mzone.h"
+#include	"tgrid.h"
+#include	"backref.h"
+#include	"shpcache.h"
 #include	"display.h"
 #include	"radar.h"
+#include	"radimage.h"
 #include	"power.h"
 #include	"sidebar.h"
 #include	"tab.h"
@@ -263,6 +269,7 @@ CELL Coord_Cell(COORDINATE coord);
 #include	"taction.h"
 #include	"tevent.h"
 #include	"trigger.h"			// Trigger event objects.
+#include	"trigdisp.h"
 #include	"mapedit.h"			// map editor class
 #include	"abstract.h"
 #include "object.h"
@@ -284,6 +291,7 @@ CELL Coord_Cell(COORDINATE coord);
 #include "intro.h"
 #include "ending.h"
 #include	"logic.h"
+#include	"snapshot.h"		// Render snapshot for frame interpolation.
 #include	"queue.h"
 #include	"event.h"
 #include "base.h"				// defines the AI's pre-built base
@@ -573,6 +581,7 @@ unsigned short Get_Build_Frame_X(void const *dataptr);
 unsigned short Get_Build_Frame_Y(void const *dataptr);
 unsigned short Get_Build_Frame_Width(void const *dataptr);
 unsigned short Get_Build_Frame_Height(void const *dataptr);
+unsigned long Get_Build_Frame_Offset(void const *dataptr, unsigned short framenumber);
 bool Get_Build_Frame_Palette(void const *dataptr, void *palette);
 
 /*
@@ -711,6 +720,7 @@ bool Queue_Options(void);
 bool Queue_Exit(void);
 void Queue_AI(void);
 void Add_CRC(unsigned long *crc, unsigned long val);
+unsigned long Game_CRC(void);
 
 /*
 **	RANDOM.CPP
@@ -739,6 +749,7 @@ bool Get_Savefile_Info(int id, char * buf, unsigned * scenp, HousesType * housep
 bool Load_Game(int id);
 bool Read_Object (void * ptr, int base_size, int class_size, FileClass & file, void * vtable);
 bool Save_Game(int id, char const * descr, bool bargraph=false);
+void Save_Game_Wait(void);
 bool Write_Object (void * ptr, int class_size, FileClass & file);
 void Code_All_Pointers(void);
 void Decode_All_Pointers(void);
@@ -87,6 +87,12 @@ class GScreenClass
 		*/
 		virtual void Blit_Display(void);
 
+		/*
+		**	Records an area of the hidpage that was drawn to, so that only the changed
+		**	parts of the display need to be presented.
+		*/
+		static void Flag_Area(int x, int y, int w, int h);
+
 		/*
 		**	Changes the mouse shape as indicated.
 		*/
@@ -68,6 +68,9 @@ class FixedHeapClass
 		void const * operator[](int index) const {return ((char *)Buffer) + (index * Size);};
 
 	protected:
+		void * Allocate(int index);
+		bool Is_Allocated(int index) const {return((UsedBits[index / 32] & (1U << (index % 32))) != 0);};
+
 		/*
 		**	If the memory block buffer was allocated by this class, then this flag
 		**	will be true. The block must be deallocated by this class if true.
@@ -96,11 +99,18 @@ class FixedHeapClass
 		void * Buffer;
 
 		/*
-		**	This is a boolean vector array of allocation flag bits.
+		**	These are the allocation flag bits, one for each sub-block, packed 32 to
+		**	a word. Each summary bit flags an allocation word that is completely in
+		**	use, so the lowest free sub-block can be found without scanning every
+		**	allocation word.
 		*/
-		BooleanVectorClass FreeFlag;
+		unsigned * UsedBits;
+		unsigned * FullBits;
 
 	private:
+		int First_Free(void) const;
+		void Reset_Bits(void);
+
 		// The assignment operator is not supported.
 		FixedHeapClass & operator = (FixedHeapClass const &);
 
@@ -135,13 +145,15 @@ class TFixedHeapClass : public FixedHeapClass
 **	This is a derivative of the fixed heap class. This class adds the
 **	ability to quickly iterate through the active (allocated) objects. Since the
 **	active array is a sequence of pointers, the overhead of this class
-**	is 4 bytes per potential allocated object (be warned).
+**	is 8 bytes per potential allocated object (be warned). The active array is
+**	always in allocation order. Each object records when it was allocated so
+**	that it can be found in the active array by a binary search.
 */
 class FixedIHeapClass : public FixedHeapClass
 {
 	public:
-		FixedIHeapClass(int size) : FixedHeapClass(size) {};
-		virtual ~FixedIHeapClass(void) {};
+		FixedIHeapClass(int size) : FixedHeapClass(size), Stamp(0), NextStamp(0) {};
+		virtual ~FixedIHeapClass(void) {delete [] Stamp;};
 
 		virtual int Set_Heap(int count, void * buffer=0);
 		virtual void * Allocate(void);
@@ -161,6 +173,17 @@ class FixedIHeapClass : public FixedHeapClass
 		**	performed.
 		*/
 		DynamicVectorClass<void *> ActivePointers;
+
+	protected:
+		void * Allocate(int index);
+		void Add_Active(void * pointer);
+
+		/*
+		**	The allocation stamp of each sub-block. The stamps of the objects in the
+		**	active array always increase from the first to the last.
+		*/
+		long * Stamp;
+		long NextStamp;
 };
 
 
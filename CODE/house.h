@@ -580,6 +580,22 @@ class HouseClass {
 		int VQuantity[VESSEL_COUNT];
 #endif
 
+		/*
+		**	Number of objects of each type owned by this house and, of those, the number
+		**	that are on active duty. The existence and active scan bits are set exactly
+		**	when the matching tally is greater than zero.
+		*/
+		short BTally[STRUCT_COUNT];
+		short ActiveBTally[STRUCT_COUNT];
+		short UTally[UNIT_COUNT];
+		short ActiveUTally[UNIT_COUNT];
+		short ITally[INFANTRY_COUNT];
+		short ActiveITally[INFANTRY_COUNT];
+		short ATally[AIRCRAFT_COUNT];
+		short ActiveATally[AIRCRAFT_COUNT];
+		short VTally[VESSEL_COUNT];
+		short ActiveVTally[VESSEL_COUNT];
+
 		/*
 		**	This timer keeps track of when an all out attack should be performed.
 		**	When this timer expires, send most of this house's units in an
@@ -720,6 +736,7 @@ class HouseClass {
 		void Tracking_Add(TechnoClass const * techno);
 		void Active_Remove(TechnoClass const * techno);
 		void Active_Add(TechnoClass const * techno);
+		void Scan_Tally(TechnoClass const * techno, bool active, int adjust);
 
 		UrgencyType Check_Attack(void) const;
 		UrgencyType Check_Build_Power(void) const;
@@ -751,6 +768,7 @@ class HouseClass {
 		static void One_Time(void);
 		static HouseClass * As_Pointer(HousesType house);
 		static void Recalc_Attributes(void);
+		static void Verify_Attributes(void);
 
 		/*
 		**	File I/O.
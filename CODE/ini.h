@@ -54,7 +54,7 @@
 */
 class INIClass {
 	public:
-		INIClass(void) {}
+		INIClass(void) : ArenaList(0) {}
 		~INIClass(void);
 
 		/*
@@ -65,6 +65,12 @@ class INIClass {
 		int Save(FileClass & file) const;
 		int Save(Pipe & file) const;
 
+		/*
+		**	Fetch and store the INI data as a compiled binary image (see INIBIN.CPP).
+		*/
+		bool Load_Binary(Straw & file);
+		int Save_Binary(Pipe & file) const;
+
 		/*
 		**	Erase all data within this INI file manager.
 		*/
@@ -117,15 +123,18 @@ class INIClass {
 
 		/*
 		**	The value entries for the INI file are stored as objects of this type.
-		**	The entry identifier and value string are combined into this object.
+		**	The entry identifier and value string are combined into this object. Entries
+		**	built by Load() live in the load arena and point into the loaded text, so
+		**	they own nothing.
 		*/
 		struct INIEntry : Node<INIEntry> {
-			INIEntry(char * entry = 0, char * value = 0) : Entry(entry), Value(value) {}
-			~INIEntry(void) {free(Entry);Entry = 0;free(Value);Value = 0;}
+			INIEntry(char * entry = 0, char * value = 0, bool inarena = false) : Entry(entry), Value(value), IsArena(inarena) {}
+			~INIEntry(void) {if (!IsArena) {free(Entry);free(Value);} Entry = 0;Value = 0;}
 			int Index_ID(void) const {return(CRCEngine()(Entry, strlen(Entry)));};
 
 			char * Entry;
 			char * Value;
+			bool IsArena;
 		};
 
 		/*
@@ -133,16 +142,37 @@ class INIClass {
 		**	subordinate to this section are attached.
 		*/
 		struct INISection : Node<INISection> {
-			INISection(char * section) : Section(section) {}
-			~INISection(void) {free(Section);Section = 0;EntryList.Delete();}
+			INISection(char * section, bool inarena = false) : Section(section), IsArena(inarena) {}
+			~INISection(void);
 			INIEntry * Find_Entry(char const * entry) const;
 			int Index_ID(void) const {return(CRCEngine()(Section, strlen(Section)));};
 
 			char * Section;
+			bool IsArena;
 			List<INIEntry> EntryList;
 			IndexClass<INIEntry *>EntryIndex;
 		};
 
+		/*
+		**	Loaded INI text and the nodes built from it are kept in these blocks. They
+		**	are only released when the whole database is cleared.
+		*/
+		struct INIArena {
+			INIArena * Next;
+			int Size;
+			int Used;
+		};
+		enum {
+			ARENA_HEADER=(sizeof(INIArena) + 7) & ~7,
+			ARENA_BLOCK_SIZE=16*1024
+		};
+		static char * Arena_Data(INIArena * arena) {return(((char *)arena) + ARENA_HEADER);}
+		void * Arena_Alloc(int size);
+		char * Load_Text(Straw & file, int & length);
+		void Free_Arenas(void);
+		static void Destroy(INIEntry * entry);
+		static void Destroy(INISection * section);
+
 		/*
 		**	Utility routines to help find the appropriate section and entry objects.
 		*/
@@ -156,6 +186,8 @@ class INIClass {
 		List<INISection> SectionList;
 
 		IndexClass<INISection *> SectionIndex;
+
+		INIArena * ArenaList;
 };
 
 
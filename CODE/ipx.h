@@ -184,6 +184,7 @@ int IPX_Get_Local_Target(unsigned char *dest_network, unsigned char *dest_node,
 	unsigned short dest_socket, unsigned char *bridge_address);
 int IPX_Cancel_Event(struct ECB *ecb_ptr);
 void Let_IPX_Breath(void);
+void IPX_Flush_Packets(void);
 
 #endif
 
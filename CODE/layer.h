@@ -45,6 +45,8 @@ class ObjectClass;
 class LayerClass : public DynamicVectorClass<ObjectClass *>
 {
 	public:
+		LayerClass(void) : SortBuffer(0), SortMax(0) {};
+		virtual ~LayerClass(void) {delete [] SortBuffer;SortBuffer = 0;};
 
 		//-----------------------------------------------------------------
 		void Sort(void);
@@ -62,6 +64,25 @@ class LayerClass : public DynamicVectorClass<ObjectClass *>
 		bool Save(Pipe & file) const;
 		virtual void Code_Pointers(void);
 		virtual void Decode_Pointers(void);
+
+	private:
+		/*
+		**	Sort key and object pair. The key is the object's Sort_Y() value, fetched
+		**	once per sort rather than on every comparison.
+		*/
+		struct SortEntry {
+			COORDINATE Key;
+			ObjectClass * Object;
+		};
+
+		void Radix_Sort(SortEntry * entries, SortEntry * scratch, int count);
+
+		/*
+		**	Working storage for Sort(). It holds twice SortMax entries; the second half
+		**	is the radix sort's output buffer.
+		*/
+		SortEntry * SortBuffer;
+		int SortMax;
 };
 
 #endif
@@ -9,9 +9,9 @@
 /*
  * Convert the game's 8-bit GraphicBufferClass surface to an LVGL canvas.
  * The routine creates a canvas the first time it's called and reuses it on
- * subsequent frames. Each call updates the palette and copies the frame
- * buffer to the canvas so LVGL can present the image on the selected
- * backend.
+ * subsequent frames. The game reports the areas it drew to through
+ * lvgl_mark_dirty() and only those areas are copied to the canvas and
+ * invalidated. The palette is only pushed to the canvas when it changes.
  */
 /*
  * Minimal C representation of the GraphicBufferClass fields that are
@@ -42,6 +42,67 @@ struct gbc_fields {
     struct bc_fields   buf;
 };
 
+/*
+ * Areas of the game page drawn to since the last blit. When more areas are
+ * reported than fit in the list, the new area is merged into whichever entry
+ * grows the least. A full refresh is pending until the first blit.
+ */
+#define DIRTY_MAX 32
+
+static lv_area_t dirty[DIRTY_MAX];
+static int dirty_count = 0;
+static int dirty_all = 1;
+
+static int32_t area_size(const lv_area_t *a)
+{
+    return (a->x2 - a->x1 + 1) * (a->y2 - a->y1 + 1);
+}
+
+static void area_join(lv_area_t *res, const lv_area_t *a, const lv_area_t *b)
+{
+    res->x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+    res->y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+    res->x2 = a->x2 > b->x2 ? a->x2 : b->x2;
+    res->y2 = a->y2 > b->y2 ? a->y2 : b->y2;
+}
+
+void lvgl_mark_dirty(int x, int y, int w, int h)
+{
+    if(dirty_all || w <= 0 || h <= 0)
+        return;
+
+    lv_area_t area = {x, y, x + w - 1, y + h - 1};
+
+    /* Skip areas already covered and absorb areas the new one covers */
+    for(int i = 0; i < dirty_count; i++) {
+        if(area.x1 >= dirty[i].x1 && area.y1 >= dirty[i].y1 &&
+           area.x2 <= dirty[i].x2 && area.y2 <= dirty[i].y2)
+            return;
+        if(dirty[i].x1 >= area.x1 && dirty[i].y1 >= area.y1 &&
+           dirty[i].x2 <= area.x2 && dirty[i].y2 <= area.y2) {
+            dirty[i--] = dirty[--dirty_count];
+        }
+    }
+
+    if(dirty_count < DIRTY_MAX) {
+        dirty[dirty_count++] = area;
+        return;
+    }
+
+    int best = 0;
+    int32_t best_growth = 0;
+    for(int i = 0; i < dirty_count; i++) {
+        lv_area_t joined;
+        area_join(&joined, &dirty[i], &area);
+        int32_t growth = area_size(&joined) - area_size(&dirty[i]);
+        if(i == 0 || growth < best_growth) {
+            best = i;
+            best_growth = growth;
+        }
+    }
+    area_join(&dirty[best], &dirty[best], &area);
+}
+
 void lvgl_blit(const struct GraphicBufferClass *page)
 {
     const struct gbc_fields *gbc = (const struct gbc_fields *)page;
@@ -65,25 +126,57 @@ void lvgl_blit(const struct GraphicBufferClass *page)
         lv_scr_load(canvas);
     }
 
-    /* Update the palette from the game's global palette data */
-    LOG_CALL("update palette\n");
-    for(int i = 0; i < 256; i++) {
-        lv_color32_t col = lv_color32_make(CurrentPalette[i * 3],
-                                           CurrentPalette[i * 3 + 1],
-                                           CurrentPalette[i * 3 + 2],
-                                           0xFF);
-        lv_canvas_set_palette(canvas, i, col);
+    /* Push the palette to the canvas only when the game has changed it */
+    static uint8_t last_palette[256 * 3];
+    static int palette_set = 0;
+    int palette_changed = !palette_set ||
+                          memcmp(last_palette, CurrentPalette, sizeof(last_palette)) != 0;
+
+    if(palette_changed) {
+        LOG_CALL("update palette\n");
+        for(int i = 0; i < 256; i++) {
+            lv_color32_t col = lv_color32_make(CurrentPalette[i * 3],
+                                               CurrentPalette[i * 3 + 1],
+                                               CurrentPalette[i * 3 + 2],
+                                               0xFF);
+            lv_canvas_set_palette(canvas, i, col);
+        }
+        memcpy(last_palette, CurrentPalette, sizeof(last_palette));
+        palette_set = 1;
     }
 
-    /* Wrap the game's buffer and copy it to the canvas */
+    /* Wrap the game's buffer and copy the changed areas to the canvas */
     lv_draw_buf_t src_buf;
     uint32_t stride = gbc->view.width + gbc->view.pitch;
     lv_draw_buf_init(&src_buf, w, h, LV_COLOR_FORMAT_I8, stride,
                      gbc->buf.buffer, stride * h);
 
-    lv_area_t area = {0, 0, w - 1, h - 1};
-    LOG_CALL("copy frame to canvas\n");
-    lv_draw_buf_copy(canvas_buf, &area, &src_buf, &area);
-    lv_obj_invalidate(canvas);
-}
+    lv_area_t full = {0, 0, w - 1, h - 1};
+    lv_area_t coords;
+    lv_obj_get_coords(canvas, &coords);
+
+    if(dirty_all) {
+        LOG_CALL("copy frame to canvas\n");
+        lv_draw_buf_copy(canvas_buf, &full, &src_buf, &full);
+        lv_obj_invalidate(canvas);
+    } else {
+        LOG_CALL("copy %d areas to canvas\n", dirty_count);
+        for(int i = 0; i < dirty_count; i++) {
+            lv_area_t area;
+            if(!lv_area_intersect(&area, &dirty[i], &full))
+                continue;
+            lv_draw_buf_copy(canvas_buf, &area, &src_buf, &area);
 
+            /* A palette change repaints the whole canvas below anyway */
+            if(!palette_changed) {
+                lv_area_move(&area, coords.x1, coords.y1);
+                lv_obj_invalidate_area(canvas, &area);
+            }
+        }
+        if(palette_changed)
+            lv_obj_invalidate(canvas);
+    }
+
+    dirty_all = 0;
+    dirty_count = 0;
+}
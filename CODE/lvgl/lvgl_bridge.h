@@ -8,6 +8,7 @@ extern "C" {
 struct GraphicBufferClass;
 
 void lvgl_blit(const struct GraphicBufferClass *page);
+void lvgl_mark_dirty(int x, int y, int w, int h);
 
 #ifdef __cplusplus
 }
@@ -83,11 +83,18 @@ class MapClass: public GScreenClass
 		bool Place_Random_Crate(void);
 		bool Remove_Crate(CELL cell);
 		bool Zone_Reset(int method);
+		void Zone_Update(int method);
 		bool Zone_Cell(CELL cell, int zone);
 		int Zone_Span(CELL cell, int zone, MZoneType check);
 		bool Destroy_Bridge_At(CELL cell);
 		void Detach(TARGET target, bool all=true);
 		void Shroud_The_Map(void);
+		void Ore_Field_Adjust(CELL cell, int adjust);
+		void Ore_Field_Recalc(void);
+		int Ore_Field_Distance(CELL cell) const;
+		bool Ore_Field_Ring(CELL cell, int radius) const;
+		void Mapped_Bits_Adjust(CELL cell);
+		void Mapped_Bits_Recalc(void);
 
 		long Overpass(void);
 
@@ -174,6 +181,32 @@ class MapClass: public GScreenClass
 		*/
 		CELL TiberiumScan;
 
+		/*
+		**	Count of the Tiberium cells within each square block of the map. Harvesters use
+		**	this to skip over the empty stretches of map when searching for Tiberium.
+		*/
+		enum OreFieldEnum {
+			ORE_FIELD_SHIFT=3,
+			ORE_FIELD_W=MAP_CELL_W>>ORE_FIELD_SHIFT,
+			ORE_FIELD_H=MAP_CELL_H>>ORE_FIELD_SHIFT
+		};
+		unsigned char OreField[ORE_FIELD_H][ORE_FIELD_W];
+
+		bool Ore_Field_Any(int x1, int y1, int x2, int y2) const;
+
+		/*
+		**	One bit for each cell that the player has mapped. Every row has an extra word on
+		**	each side with all bits set so that sight circles can be checked against the map a
+		**	word at a time without worrying about the map edges.
+		*/
+		enum MappedBitsEnum {
+			MAPPED_PAD=32,
+			MAPPED_WORDS=(MAP_CELL_W+MAPPED_PAD*2)/32
+		};
+		unsigned MappedBits[MAP_CELL_H][MAPPED_WORDS];
+
+		bool Sight_Is_Mapped(CELL cell, int sightrange, bool incremental) const;
+
 		enum MapEnum {SCAN_AMOUNT=MAP_CELL_TOTAL};
 };
 
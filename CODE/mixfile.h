@@ -61,6 +61,8 @@ class MixFileClass : public Node<MixFileClass>
 	private:
 		static MixFileClass * Finder(char const * filename);
 		long Offset(long crc, long * size = 0) const;
+		static void Hash_Rebuild(void);
+		bool Map(void);
 
 		/*
 		**	If this mixfile has an attached message digest, then this flag
@@ -82,6 +84,18 @@ class MixFileClass : public Node<MixFileClass>
 		*/
 		unsigned IsAllocated:1;
 
+		/*
+		**	If the data block is mapped straight from the mixfile on disk (rather than
+		**	read into a copy in RAM), then this flag will be true. The mapping is private
+		**	and writable, since Build_Frame stamps its cache slot into the keyframe
+		**	headers of the shapes it holds; those pages become private copies and the
+		**	file is never written. MapBase and MapSize describe the page aligned
+		**	mapping that contains the data block.
+		*/
+		unsigned IsMapped:1;
+		void * MapBase;
+		long MapSize;
+
 		/*
 		**	This is the initial file header. It tells how many files are embedded
 		**	within this mixfile and the total size of all embedded files.
@@ -119,6 +133,21 @@ class MixFileClass : public Node<MixFileClass>
 		void * Data;						// Pointer to raw data.
 
 		static List<MixFileClass> List;
+
+		/*
+		**	Every embedded file of every registered mixfile is entered into this open
+		**	addressed table, keyed by CRC. When the same file appears in more than one
+		**	mixfile, the one registered first wins, as the old list search did. The
+		**	table is rebuilt whenever a mixfile is registered or destroyed.
+		*/
+		struct HashEntry {
+			long CRC;
+			MixFileClass * Mixfile;
+			long Offset;
+			long Size;
+		};
+		static HashEntry * Hash;
+		static int HashSize;
 };
 
 #endif
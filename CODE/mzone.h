@@ -0,0 +1,164 @@
+/*
+**	Command & Conquer Red Alert(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Command & Conquer                                            *
+ *                                                                                             *
+ *                    File Name : MZONE.H                                                      *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef MZONE_H
+#define MZONE_H
+
+/*
+**	This tracks the connected movement regions of the map so that the zone numbers stored in
+**	CellClass::Zones[] can be kept current without flood filling the whole map every time a
+**	wall, bridge or tree changes. Each region (cells joined along their sides) is kept as a
+**	linked list of its cells. When a cell opens up, the regions around it are merged. When a
+**	cell closes, only the pieces that broke away are searched and relabeled. Regions that meet
+**	only at a corner gap are joined into zones the same way the MapClass::Zone_Span flood fill
+**	joins them, so the zone numbers written to the map are always the same as a full
+**	MapClass::Zone_Reset would produce.
+*/
+class MoveZoneClass
+{
+	public:
+		MoveZoneClass(void);
+
+		void Touch(CELL cell);
+		void Rebuild(int method);
+		void Update(int method);
+
+		/*
+		**	The cells waiting for the next update and the zone types (MZONEF_xxx) that
+		**	have yet to examine each one.
+		*/
+		int Pending_Count(void) const {return(PendingCount);};
+		CELL Pending_Cell(int index) const {return(Pending[index]);};
+		int Pending_Zones(CELL cell) const {return(PendingFlags[cell]);};
+
+	private:
+		enum {
+			COMPONENT_MAX=1024,		// Maximum number of regions.
+			ZONE_MAX=255,				// Maximum number of zones (zone numbers are a byte).
+			PENDING_MAX=256,			// Maximum cells that can be waiting for an update.
+			SEARCH_MAX=4				// One search per side of a closed cell.
+		};
+
+		/*
+		**	Each connected region is described by one of these.
+		*/
+		typedef struct {
+			CELL Head;					// First cell in the region's cell list.
+			CELL MinCell;				// Lowest cell number in the region (sets the zone number).
+			short Count;				// Number of cells in the region.
+			unsigned char Zone;		// Zone number currently written to the map.
+			unsigned IsActive:1;		// Is this region in use?
+			unsigned IsStale:1;		// Must the zone number be rewritten to every cell?
+		} ComponentType;
+
+		bool Is_Passable(CELL cell, MZoneType check) const;
+		bool Gap_Ends(CELL corner, MZoneType check, CELL & right, CELL & left) const;
+		void Gap_Update(CELL cell, MZoneType check);
+		bool Assign_Zones(MZoneType check);
+		void Open_Cell(CELL cell, MZoneType check);
+		void Close_Cell(CELL cell, MZoneType check);
+		void Renumber(MZoneType check);
+		int New_Component(MZoneType check);
+		void Free_Component(int comp, MZoneType check);
+		void Link(CELL cell, int comp, MZoneType check);
+		void Unlink(CELL cell, MZoneType check);
+		void Find_Min_Cell(int comp, MZoneType check);
+		void Remove_Pending(MZoneType check);
+
+		/*
+		**	If the region table overflowed, then this zone type cannot be tracked
+		**	incrementally and every update falls back to a full zone reset.
+		*/
+		bool IsValid[MZONE_COUNT];
+
+		/*
+		**	Region number of every cell (-1 if impassable) and the doubly linked list
+		**	that ties the cells of a region together.
+		*/
+		short Component[MZONE_COUNT][MAP_CELL_TOTAL];
+		CELL NextCell[MZONE_COUNT][MAP_CELL_TOTAL];
+		CELL PrevCell[MZONE_COUNT][MAP_CELL_TOTAL];
+
+		ComponentType Components[MZONE_COUNT][COMPONENT_MAX];
+
+		/*
+		**	Active regions kept in order of their lowest cell. This is the order in which
+		**	the flood fill starts its zones.
+		*/
+		short Order[MZONE_COUNT][COMPONENT_MAX];
+		int OrderCount[MZONE_COUNT];
+
+		/*
+		**	Unused region numbers.
+		*/
+		short Free[MZONE_COUNT][COMPONENT_MAX];
+		int FreeCount[MZONE_COUNT];
+
+		/*
+		**	Corner gaps: 2x2 blocks where only the two cells on one diagonal are in a region.
+		**	The flood fill only crosses a gap from its right hand cell to its left hand
+		**	cell. Each gap is listed by its upper left cell, and the index of every listed
+		**	cell in the list is kept so it can be removed quickly (-1 if not listed).
+		*/
+		CELL Gaps[MZONE_COUNT][MAP_CELL_TOTAL];
+		short GapIndex[MZONE_COUNT][MAP_CELL_TOTAL];
+		int GapCount[MZONE_COUNT];
+
+		/*
+		**	Working data for assigning zones to regions. Regions reached across a gap are
+		**	kept on a list for each region.
+		*/
+		short ZoneOf[COMPONENT_MAX];
+		short EdgeHead[COMPONENT_MAX];
+		short EdgeNext[MAP_CELL_TOTAL];
+		short EdgeTarget[MAP_CELL_TOTAL];
+		short ZoneStack[COMPONENT_MAX];
+
+		/*
+		**	Cells whose passability has changed. Each cell has a bit for every zone
+		**	type that has yet to examine it.
+		*/
+		CELL Pending[PENDING_MAX];
+		int PendingCount;
+		unsigned char PendingFlags[MAP_CELL_TOTAL];
+		bool IsOverflow[MZONE_COUNT];
+
+		/*
+		**	Working data for the split search. Every cell is visited by at most one search,
+		**	so the visit list can be threaded through a per cell link.
+		*/
+		unsigned short VisitStamp[MAP_CELL_TOTAL];
+		unsigned char VisitOwner[MAP_CELL_TOTAL];
+		CELL VisitNext[MAP_CELL_TOTAL];
+		unsigned short Stamp;
+};
+
+
+#endif
@@ -0,0 +1,151 @@
+/*
+**	Command & Conquer Red Alert(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Command & Conquer                                            *
+ *                                                                                             *
+ *                    File Name : PATHGRPH.H                                                   *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef PATHGRPH_H
+#define PATHGRPH_H
+
+/*
+**	This is the abstract (cluster level) movement graph that sits on top of the cell based
+**	path finder. The map is carved into square clusters. Each contiguous passable region
+**	within a cluster becomes a node and nodes that touch across a cluster boundary are
+**	joined by an edge. Long distance movement plans a route through this graph first and
+**	then hands the cell level path finder a nearby waypoint along that route. This keeps
+**	the cost of FootClass::Find_Path bounded no matter how far away the destination is.
+*/
+class PathGraphClass
+{
+	public:
+		PathGraphClass(void);
+
+		void Invalidate(int method=MZONEF_ALL);
+		void Touch(CELL cell, int method=MZONEF_ALL);
+		CELL Waypoint(CELL source, CELL dest, MZoneType check);
+
+	private:
+		/*
+		**	Size (in cells) of one side of a cluster. The maximum number of regions
+		**	in a cluster is bounded by this since each region is tracked with a byte.
+		*/
+		enum {
+			CLUSTER_SIZE=8,
+			CLUSTER_W=MAP_CELL_W/CLUSTER_SIZE,
+			CLUSTER_H=MAP_CELL_H/CLUSTER_SIZE,
+			CLUSTER_COUNT=CLUSTER_W*CLUSTER_H,
+
+			/*
+			**	No two regions can both have a cell in the same 2x2 block (those cells all
+			**	touch), so a cluster holds at most one region per 2x2 block. Each cluster
+			**	has this many node numbers set aside so that rebuilding one cluster never
+			**	renumbers the nodes of another.
+			*/
+			REGION_MAX=(CLUSTER_SIZE/2)*(CLUSTER_SIZE/2),
+			NODE_MAX=CLUSTER_COUNT*REGION_MAX,
+
+			/*
+			**	Edge table entries set aside for the nodes of each cluster.
+			*/
+			CLUSTER_EDGE_MAX=96,
+			OPEN_MAX=8192,
+
+			/*
+			**	Number of abstract nodes along the route to look ahead when picking the
+			**	waypoint for the cell level search.
+			*/
+			LOOKAHEAD=2
+		};
+
+		/*
+		**	Each region within a cluster is represented by one of these nodes.
+		*/
+		typedef struct {
+			CELL Center;				// Member cell closest to the region centroid.
+			short FirstEdge;			// Index into the edge table.
+			short Cluster;				// Cluster number (index into cluster grid).
+			unsigned char EdgeCount;	// Number of edges for this node.
+		} PathNodeType;
+
+		bool Build(MZoneType check);
+		bool Refresh(MZoneType check);
+		bool Is_Passable(CELL cell, MZoneType check) const;
+		int Label_Cluster(int cluster, MZoneType check);
+		void Make_Nodes(int cluster, MZoneType check);
+		bool Link_Cluster(int cluster, MZoneType check);
+		int Node_Of(CELL cell, MZoneType check) const;
+		bool Search(int start, int goal, MZoneType check);
+		static int Cost(CELL cell1, CELL cell2);
+
+		/*
+		**	Records whether the graph for each movement zone type needs to be rebuilt
+		**	before it can be used.
+		*/
+		bool IsDirty[MZONE_COUNT];
+
+		/*
+		**	If the graph could not be built (the edge table of a cluster overflowed),
+		**	then this flag is false and the path finder operates as if this layer did
+		**	not exist.
+		*/
+		bool IsValid[MZONE_COUNT];
+
+		/*
+		**	Clusters that hold a cell that changed since the graph was last brought up to
+		**	date. Each cluster has a bit for every zone type that has yet to rebuild it.
+		*/
+		unsigned char ClusterTouched[CLUSTER_COUNT];
+		bool IsTouched[MZONE_COUNT];
+
+		/*
+		**	Local region number (1..n) of every cell within its cluster. Zero means the
+		**	cell is not passable.
+		*/
+		unsigned char Label[MZONE_COUNT][MAP_CELL_TOTAL];
+
+		/*
+		**	The number of regions in each cluster. The node for a cell is the cluster
+		**	number times REGION_MAX plus the local region number minus one.
+		*/
+		unsigned char RegionCount[MZONE_COUNT][CLUSTER_COUNT];
+
+		PathNodeType Nodes[MZONE_COUNT][NODE_MAX];
+		short Edges[MZONE_COUNT][CLUSTER_COUNT*CLUSTER_EDGE_MAX];
+
+		/*
+		**	Working data for the route search. The stamp value allows these arrays to be
+		**	reused without clearing them before every search.
+		*/
+		unsigned short Stamp[NODE_MAX];
+		unsigned short SearchStamp;
+		unsigned short CostSoFar[NODE_MAX];
+		short Parent[NODE_MAX];
+		long Open[OPEN_MAX];
+};
+
+
+#endif
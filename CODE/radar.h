@@ -84,7 +84,7 @@ class RadarClass: public DisplayClass
 		void Set_Radar_Position(CELL cell);
 		CELL Radar_Position(void);
 		bool Radar_Activate(int control);
-		void Plot_Radar_Pixel(CELL cell);
+		void Plot_Radar_Pixel(CELL cell, bool terrain=true);
 		void Radar_Pixel(CELL cell);
 		void Coord_To_Radar_Pixel(COORDINATE coord, int &x, int &y);
 		void Cursor_Cell(CELL cell, int value);
@@ -0,0 +1,106 @@
+/*
+**	Command & Conquer Red Alert(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Command & Conquer                                            *
+ *                                                                                             *
+ *                    File Name : RADIMAGE.H                                                   *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef RADIMAGE_H
+#define RADIMAGE_H
+
+/*
+**	This holds the terrain part of the zoomed radar map. Every template icon that appears on
+**	the radar is scaled down to the zoom factor only once per theater and kept in a tile
+**	cache. The tiles are assembled into a terrain image of the cells in the radar view, and
+**	that image only changes when the view moves or a cell's template changes. A full radar
+**	redraw blits the whole terrain image and then draws the units, overlays and shroud over
+**	it, cell by cell.
+*/
+class RadarImageClass
+{
+	public:
+		RadarImageClass(void);
+		~RadarImageClass(void);
+
+		void Clear(void);
+		void Set_View(unsigned cellx, unsigned celly, unsigned width, unsigned height, int zoom);
+		void Update(CELL cell, CellClass const & cellptr);
+		void Blit(GraphicViewPortClass & page, int x, int y);
+		void Blit_Cell(GraphicViewPortClass & page, CELL cell, int x, int y);
+
+	private:
+		enum RadarImageEnums {
+			ICON_SIZE=24,				// Pixel width and height of a template icon.
+			ICON_LIMIT=256,			// Number of logical icons a template can have.
+			KEY_NONE=-1					// Key of a terrain image cell with nothing in it.
+		};
+
+		/*
+		**	The tiles that have been made from one template. Each entry is the index of
+		**	the tile made from that logical icon (-1 if it hasn't been made yet).
+		*/
+		struct TileSetType {
+			void const * Iconset;
+			short Slot[ICON_LIMIT];
+		};
+
+		int Tile(TemplateType ttype, void const * iconset, int icon);
+		void Flush_Tiles(void);
+		void Flush_Image(void);
+
+		/*
+		**	The tile sets of every template (allocated as needed) and the pixels of
+		**	every tile made so far, Zoom*Zoom bytes each.
+		*/
+		TileSetType * Tiles[TEMPLATE_COUNT];
+		DynamicVectorClass<unsigned char> Pixels;
+
+		/*
+		**	Work areas for scaling a template icon down to a tile.
+		*/
+		GraphicBufferClass IconStage;
+		GraphicBufferClass * TileStage;
+
+		/*
+		**	The terrain image of the radar view and, for each cell in it, the template
+		**	and icon that it shows.
+		*/
+		GraphicBufferClass * Image;
+		long * Key;
+
+		/*
+		**	The radar view and theater that the tiles and the terrain image were made for.
+		*/
+		unsigned ViewX;
+		unsigned ViewY;
+		unsigned ViewWidth;
+		unsigned ViewHeight;
+		int Zoom;
+		TheaterType Theater;
+};
+
+
+#endif
@@ -0,0 +1,107 @@
+/*
+**	Command & Conquer Red Alert(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Command & Conquer                                            *
+ *                                                                                             *
+ *                    File Name : SHPCACHE.H                                                   *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef SHPCACHE_H
+#define SHPCACHE_H
+
+/*
+**	This holds recently drawn shape frames in their decoded form. Building a frame from the
+**	keyframe data means uncompressing the key frame and then applying every delta up to the
+**	one requested. Infantry and other animated objects draw the same handful of frames over
+**	and over, so keeping the finished images around turns most draws into a straight blit.
+**	Frames are kept until the memory budget is used up, after which the frame that has gone
+**	the longest without being drawn is thrown away to make room.
+*/
+class ShapeCacheClass
+{
+	public:
+		enum {
+			DEFAULT_BUDGET=2000000L			// Default bytes of decoded frame data to keep.
+		};
+
+		ShapeCacheClass(void);
+		~ShapeCacheClass(void);
+
+		void Clear(void);
+		void Set_Budget(long budget);
+		long Get_Budget(void) const {return(Budget);};
+		void const * Get_Frame(void const * shapefile, int shapenum);
+		void Preload(void const * shapefile);
+
+	private:
+		enum {
+			HASH_SIZE=1024,				// Must be a power of two.
+			ENTRY_MAX=1024					// Maximum number of frames kept at once.
+		};
+
+		/*
+		**	Each decoded frame is recorded by one of these. Besides the shape pointer and
+		**	frame number, the shape header and frame offset are remembered so that a new
+		**	shape file loaded at the same address as an old one is not mistaken for it.
+		*/
+		typedef struct {
+			void const * Shape;
+			unsigned long Offset;
+			unsigned short Frame;
+			unsigned short Width;
+			unsigned short Height;
+			unsigned short Frames;
+			unsigned char * Data;
+			short Next;						// Next entry in the same hash bucket.
+			short Older;					// Next less recently used entry.
+			short Newer;					// Next more recently used entry.
+		} EntryType;
+
+		static int Hash(void const * shapefile, int shapenum) {return((int)((((unsigned long)shapefile >> 4) ^ ((unsigned long)shapefile >> 14) ^ ((unsigned long)shapenum * 31)) & (HASH_SIZE-1)));};
+		int Find(void const * shapefile, int shapenum) const;
+		int Store(void const * shapefile, int shapenum, void const * buffer, long size);
+		void Unlink(int index);
+		void Link_Newest(int index);
+		void Discard(int index);
+
+		short Bucket[HASH_SIZE];
+		EntryType Entries[ENTRY_MAX];
+		short FreeList;
+
+		/*
+		**	The least and most recently used entries.
+		*/
+		short Oldest;
+		short Newest;
+
+		/*
+		**	Bytes of decoded frame data currently held and the most that may be held.
+		*/
+		long Size;
+		long Budget;
+};
+
+
+#endif
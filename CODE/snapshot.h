@@ -0,0 +1,103 @@
+/*
+**	Command & Conquer Red Alert(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Command & Conquer                                            *
+ *                                                                                             *
+ *                    File Name : SNAPSHOT.H                                                   *
+ *                                                                                             *
+ *                   Start Date : October 17, 2026                                             *
+ *                                                                                             *
+ *                  Last Update : October 17, 2026                                             *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "vector.h"
+
+class ObjectClass;
+
+/***********************************************************************************************
+**	The render snapshot records where every ground object was at the end of each logic tick.
+**	While the game waits for the next tick, the display draws moving objects part way between
+**	the last two snapshots, so that motion is smooth even though the simulation only advances
+**	at the game speed rate. The game logic never reads the snapshot, so it has no effect on
+**	the simulation.
+*/
+class RenderSnapshotClass
+{
+	public:
+		RenderSnapshotClass(void) : Newest(0), Period(0), Passes(0), IsInterpolating(false) {};
+
+		void Clear(void);
+		void Capture(void);
+		void Interpolate(void);
+		void Settle(void);
+		COORDINATE Coord_Of(ObjectClass const * object, COORDINATE coord) const;
+
+	private:
+		/*
+		**	This is what is recorded for each object. The previous coordinate equals the
+		**	current one for objects that must not be interpolated (new arrivals, objects that
+		**	jumped a long way, and objects that did not move).
+		*/
+		struct SnapEntry {
+			ObjectClass * Object;
+			COORDINATE Coord;			// Render coordinate at the end of the latest tick.
+			COORDINATE Prev;			// Render coordinate at the end of the tick before.
+			COORDINATE Drawn;			// Coordinate the object was last drawn at.
+
+			bool operator == (SnapEntry const & entry) const {return(Object == entry.Object);};
+			bool operator != (SnapEntry const & entry) const {return(Object != entry.Object);};
+		};
+
+		static int _Compare(void const * left, void const * right);
+		SnapEntry const * Find(int list, ObjectClass const * object) const;
+		void Draw_At(SnapEntry & entry, COORDINATE coord);
+
+		/*
+		**	The two most recent snapshots, each sorted by object pointer. The one at 'Newest'
+		**	is the latest.
+		*/
+		DynamicVectorClass<SnapEntry> List[2];
+		int Newest;
+
+		/*
+		**	The number of timer ticks between the latest snapshot and the next logic tick.
+		*/
+		int Period;
+
+		/*
+		**	The number of interpolated display passes since the latest snapshot.
+		*/
+		int Passes;
+
+		/*
+		**	Set while an interpolated display pass is being drawn.
+		*/
+		unsigned IsInterpolating:1;
+};
+
+#endif
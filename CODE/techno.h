@@ -153,6 +153,14 @@ class TechnoClass :	public RadioClass,
 		*/
 		unsigned IsSecondShot:1;
 
+		/*
+		**	These record what this object currently contributes to the scan tallies of
+		**	its owner. The first is set while the owner counts the object as existing
+		**	and the second while the object also counts as being on active duty.
+		*/
+		unsigned IsTallied:1;
+		unsigned IsActiveTallied:1;
+
 		/*
 		**	This is the firepower and armor modifiers for this techno object. Normally,
 		**	these values are fixed at 0x0100, but they can be modified by certain
@@ -376,8 +384,10 @@ class TechnoClass :	public RadioClass,
 		/*
 		**	Map entry and exit logic.
 		*/
+		virtual bool Limbo(void);
 		virtual bool Unlimbo(COORDINATE , DirType facing=DIR_N);
 		virtual void Detach(TARGET target, bool all);
+		void Update_Scan(void);
 
 		/*
 		**	Facing translation tables that fix the flaw with 3D studio when
@@ -0,0 +1,91 @@
+/*
+**	Command & Conquer Red Alert(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Command & Conquer                                            *
+ *                                                                                             *
+ *                    File Name : TGRID.H                                                      *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef TGRID_H
+#define TGRID_H
+
+/*
+**	This is a coarse occupancy grid laid over the map. For every block of cells it records
+**	which houses have objects of each techno type sitting in that block. The target scanning
+**	logic uses it to skip over empty ground without examining every cell. It mirrors the cell
+**	occupation chains exactly, so it never changes which target is picked.
+*/
+class ThreatGridClass
+{
+	public:
+		/*
+		**	Size (in cells) of one side of a grid block.
+		*/
+		enum {
+			BLOCK_SIZE=4,
+			BLOCK_W=MAP_CELL_W/BLOCK_SIZE,
+			BLOCK_H=MAP_CELL_H/BLOCK_SIZE
+		};
+
+		ThreatGridClass(void);
+
+		void Clear(void);
+		void Recalc(void);
+		void Recount(CELL cell);
+		void Occupy_Down(CELL cell, ObjectClass const * object);
+		void Occupy_Up(CELL cell, ObjectClass const * object);
+		unsigned long Houses(CELL cell, int rttimask) const;
+
+	private:
+		/*
+		**	Only the techno object types are tracked. Everything else is ignored.
+		*/
+		enum {
+			SLOT_AIRCRAFT,
+			SLOT_BUILDING,
+			SLOT_INFANTRY,
+			SLOT_UNIT,
+			SLOT_VESSEL,
+			SLOT_COUNT
+		};
+
+		static int Slot_Of(RTTIType rtti);
+		static int Block_Of(CELL cell) {return((Cell_Y(cell)/BLOCK_SIZE)*BLOCK_W + Cell_X(cell)/BLOCK_SIZE);};
+		void Adjust(CELL cell, ObjectClass const * object, int delta);
+
+		/*
+		**	Number of objects of each house and type within each block.
+		*/
+		unsigned char Count[BLOCK_W*BLOCK_H][HOUSE_COUNT][SLOT_COUNT];
+
+		/*
+		**	Bit per house that has a non-zero count in the block. This is what
+		**	the query looks at.
+		*/
+		unsigned long Present[BLOCK_W*BLOCK_H][SLOT_COUNT];
+};
+
+
+#endif
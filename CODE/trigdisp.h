@@ -0,0 +1,170 @@
+/*
+**	Command & Conquer Red Alert(tm)
+**	Copyright 2025 Electronic Arts Inc.
+**
+**	This program is free software: you can redistribute it and/or modify
+**	it under the terms of the GNU General Public License as published by
+**	the Free Software Foundation, either version 3 of the License, or
+**	(at your option) any later version.
+**
+**	This program is distributed in the hope that it will be useful,
+**	but WITHOUT ANY WARRANTY; without even the implied warranty of
+**	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+**	GNU General Public License for more details.
+**
+**	You should have received a copy of the GNU General Public License
+**	along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/***********************************************************************************************
+ ***              C O N F I D E N T I A L  ---  W E S T W O O D  S T U D I O S               ***
+ ***********************************************************************************************
+ *                                                                                             *
+ *                 Project Name : Command & Conquer                                            *
+ *                                                                                             *
+ *                    File Name : TRIGDISP.H                                                   *
+ *                                                                                             *
+ *---------------------------------------------------------------------------------------------*
+ * Functions:                                                                                  *
+ * - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - */
+
+#ifndef TRIGDISP_H
+#define TRIGDISP_H
+
+/*
+**	This decides which of the logic triggers need to be examined each game frame. Every
+**	logic trigger is filed under the global conditions its events depend upon (globals,
+**	bridges, the mission timer) and its elapsed time events are kept on a timer wheel by
+**	the frame they expire on. A trigger is only examined when one of those conditions
+**	changes, when its timer comes due, when something else springs it, or when it was
+**	ready to go off the last time it was examined. Triggers with events that depend upon
+**	house or team state are examined every frame, just as before. The triggers that are
+**	examined are always processed in logic trigger list order, so the triggers fire in
+**	exactly the same order as when the whole list was scanned.
+*/
+class TriggerDispatchClass
+{
+	public:
+		/*
+		**	Number of frame slots in the timer wheel. Must be a power of two.
+		*/
+		enum {
+			WHEEL_SIZE=256
+		};
+
+		TriggerDispatchClass(void);
+		~TriggerDispatchClass(void);
+
+		void Clear(void);
+		void Rebuild(void);
+		void Remove(TriggerClass const * trigger);
+		void Touch(TriggerClass const * trigger);
+		void Notify(TEventType event);
+		void Process(void);
+
+	private:
+		/*
+		**	These are the conditions that a trigger can be waiting upon.
+		*/
+		enum {
+			WATCH_POLL=0x01,
+			WATCH_GLOBAL=0x02,
+			WATCH_BRIDGE=0x04,
+			WATCH_MISSION=0x08,
+			WATCH_TIME=0x10
+		};
+
+		/*
+		**	Each condition that is announced has its own list of subscribers.
+		*/
+		enum {
+			LIST_GLOBAL,
+			LIST_BRIDGE,
+			LIST_MISSION,
+			LIST_COUNT
+		};
+
+		/*
+		**	The dispatch state of each registered trigger, indexed by its position in
+		**	the logic trigger list at the time the lists were built.
+		*/
+		struct StateType {
+			TriggerClass * Trigger;
+			int Watch;
+			long Deadline;
+			unsigned IsDue:1;
+			unsigned IsHot:1;
+
+			int operator == (StateType const & s) const {return(Trigger == s.Trigger);};
+			int operator != (StateType const & s) const {return(Trigger != s.Trigger);};
+		};
+
+		/*
+		**	An entry in the timer wheel. It is stale (and ignored) if the trigger has
+		**	been rescheduled for a different frame since it was filed.
+		*/
+		struct TimerType {
+			int Sequence;
+			long Deadline;
+
+			int operator == (TimerType const & t) const {return(Sequence == t.Sequence && Deadline == t.Deadline);};
+			int operator != (TimerType const & t) const {return(!(*this == t));};
+		};
+
+		static int Watch_Of(TEventType event);
+		static bool Is_True(TEventClass const & event, TDEventClass const & td);
+		static bool Is_Ready(TriggerClass const * trigger);
+		static bool Mission_Expired(void);
+		int Sequence_Of(TriggerClass const * trigger) const;
+		void Make_Due(int sequence);
+		void Make_Hot(int sequence);
+		void Schedule(int sequence);
+		void Advance(void);
+		void Announce(int list);
+		void Back_Up(int index);
+		void Spring(TriggerClass * trigger);
+
+		/*
+		**	Dispatch state of every registered trigger, in logic trigger list order.
+		*/
+		DynamicVectorClass<StateType> State;
+
+		/*
+		**	Converts a trigger ID into its position in the State list (-1 if the
+		**	trigger isn't a registered logic trigger).
+		*/
+		int * Lookup;
+		int LookupMax;
+
+		/*
+		**	The triggers that must be examined every frame and the subscribers to each
+		**	announced condition.
+		*/
+		DynamicVectorClass<TriggerClass *> Poll;
+		DynamicVectorClass<TriggerClass *> Subscribers[LIST_COUNT];
+
+		/*
+		**	Elapsed time events waiting for their frame to arrive.
+		*/
+		DynamicVectorClass<TimerType> Wheel[WHEEL_SIZE];
+		long LastFrame;
+
+		/*
+		**	Triggers to examine this frame (sorted) and those held over for the next one.
+		*/
+		DynamicVectorClass<int> Due;
+		DynamicVectorClass<TriggerClass *> Hot;
+
+		/*
+		**	While the due triggers are being processed, this is the one being worked on.
+		**	Triggers further down the list that become due are slipped into this frame.
+		**	The rewind count is the number of triggers further down the list that were
+		**	deleted while it was being examined.
+		*/
+		int Current;
+		int Rewind;
+		unsigned IsProcessing:1;
+};
+
+
+#endif
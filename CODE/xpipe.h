@@ -67,6 +67,34 @@ class BufferPipe : public Pipe
 };
 
 
+/*
+**	This is a store-into-memory pipe terminator whose buffer grows to hold whatever is sent
+**	through it. Use it to capture a data image quickly so that the expensive processing of
+**	that image can be done later. The buffer can be detached and handed off elsewhere.
+*/
+class ArenaPipe : public Pipe
+{
+	public:
+		ArenaPipe(long reserve = 0);
+		virtual ~ArenaPipe(void);
+		virtual int Put(void const * source, int slen);
+
+		char * Get_Buffer(void) const {return(Data);}
+		long Get_Length(void) const {return(Length);}
+		bool Is_Failed(void) const {return(IsFailed);}
+		char * Detach(void);
+
+	private:
+		char * Data;
+		long Length;
+		long Size;
+		bool IsFailed;
+
+		ArenaPipe(ArenaPipe & rvalue);
+		ArenaPipe & operator = (ArenaPipe const & pipe);
+};
+
+
 /*
 **	This is a store-to-file pipe terminator. Use it as the final link in a pipe process that
 **	needs to store the data to a file. This can only serve as the last link in the chain
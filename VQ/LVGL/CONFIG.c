@@ -182,7 +182,17 @@ static VQAConfig _defaultconfig = {
 	NULL,
 
 	/* EVAFont: EVA text font. */
-	NULL
+	NULL,
+
+	/* LoaderThreads: Number of background loader threads. A value of 0 tells
+	 * the player to load frames from VQA_Play() as it always has.
+	 */
+	0,
+
+	/* PrefetchDepth: Number of frames the loader thread may keep ahead of the
+	 * drawer. A value of 0 tells the player to fill all the frame buffers.
+	 */
+	0
 };
 
 /* Supported video modes. */
@@ -470,6 +480,12 @@ void VQA_INIConfig(VQAConfig *config)
 	/* Frame and codebook buffers */
 	config->NumFrameBufs = 6;
 	config->NumCBBufs = 3;
+
+	/* Background loading */
+    GetINIString("Player", "LoaderThreads", "0", buf, 80, (char *)ininame);
+	config->LoaderThreads = atoi(buf);
+    GetINIString("Player", "PrefetchDepth", "0", buf, 80, (char *)ininame);
+	config->PrefetchDepth = atoi(buf);
 }
 
 
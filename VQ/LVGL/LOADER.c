@@ -45,6 +45,11 @@
 *     VQA_Close     - Close an opened VQA file.
 *     VQA_LoadFrame - Load the next video frame from the VQA data stream.
 *     VQA_SeekFrame - Position the movie stream to the specified frame.
+*     VQA_StartLoader  - Start loading frames on a background thread.
+*     VQA_StopLoader   - Stop the background Loader thread.
+*     VQA_LoaderDone   - Check if the background Loader has finished.
+*     VQA_FrameReady   - Check if a frame has been handed to the Drawer.
+*     VQA_ReleaseFrame - Hand a drawn frame back to the Loader.
 *
 * PRIVATE
 *     AllocBuffers  - Allocates the numerous VQA play buffers
@@ -64,6 +69,9 @@
 *     Load_SND0     - Loads an uncompressed sound chunk
 *     Load_SND1     - Loads a compressed sound chunk
 *     Load_AudFrame - Loads blocks from separate audio file, if needed.
+*     Loader_Thread - Background Loader thread body.
+*     Frames_Ahead  - Count the frames loaded but not yet drawn.
+*     Expand_Frame  - Uncompress a frame's data before it is handed over.
 *
 ****************************************************************************/
 
@@ -103,6 +111,9 @@ static void UnVQ_Nop(unsigned char *codebook, unsigned char *pointers,
                      unsigned char *buffer, unsigned long blocksperrow,
                      unsigned long numrows, unsigned long bufwidth);
 long DrawFrame_Buffer(VQAHandle *vqa);
+static void *Loader_Thread(void *arg);
+static long Frames_Ahead(VQAHandleP *vqap);
+static void Expand_Frame(VQAData *vqabuf, VQAFrameNode *frame);
 
 #if(VQAAUDIO_ON)
 static long Load_SND0(VQAHandleP *vqap, unsigned long iffsize);
@@ -284,6 +295,14 @@ long VQA_Open(VQAHandle *vqa, char const *filename, VQAConfig *config)
 				}
 				#endif
 
+				/* A background Loader needs room for the prefetched frames plus
+				 * the one being drawn and the one waiting on the page flip.
+				 */
+				if ((config->LoaderThreads > 0)
+						&& (config->NumFrameBufs < (config->PrefetchDepth + 2))) {
+					config->NumFrameBufs = (config->PrefetchDepth + 2);
+				}
+
 				/*-------------------------------------------------------------------
 				 * ALLOCATE THE BUFFERS THAT WE NEED TO PLAY THE VQA.
 				 *-----------------------------------------------------------------*/
@@ -563,6 +582,9 @@ void VQA_Close(VQAHandle *vqa)
 {
 	long (*iohandler)(VQAHandle *, long, void *, long);
 
+	/* The Loader thread must not touch the buffers once they are freed. */
+	VQA_StopLoader((VQAHandleP *)vqa);
+
 	/* Restore video mode to text. */
 	#if(VQAVIDEO_ON)
 	SetVideoMode(TEXT);
@@ -695,7 +717,7 @@ long VQA_LoadFrame(VQAHandle *vqa)
 	}
 
 	/* If we're not sleeping, initialize */
-	if (!(vqabuf->Flags & VQADATF_LSLEEP)) {
+	if (!loader->Sleeping) {
 		frame_loaded = 0;
 		loader->FrameSize = 0;
 
@@ -713,7 +735,7 @@ long VQA_LoadFrame(VQAHandle *vqa)
 	while (frame_loaded == 0) {
 
 		/* Read new chunk, only if we're not sleeping */
-		if (!(vqabuf->Flags & VQADATF_LSLEEP)) {
+		if (!loader->Sleeping) {
 
 			/* Read chunk ID */
 			if (vqap->IOHandler(vqa, VQACMD_READ, chunk, 8)) {
@@ -837,10 +859,10 @@ long VQA_LoadFrame(VQAHandle *vqa)
 
 					/* Move the last audio frame to the play buffer. */
 					if (CopyAudio(vqap) == VQAERR_SLEEPING) {
-						vqabuf->Flags |= VQADATF_LSLEEP;
+						loader->Sleeping = 1;
 						return (VQAERR_SLEEPING);
 					} else {
-						vqabuf->Flags &= (~VQADATF_LSLEEP);
+						loader->Sleeping = 0;
 					}
 
 					/* Load an uncompressed audio frame. */
@@ -860,10 +882,10 @@ long VQA_LoadFrame(VQAHandle *vqa)
 				
 					/* Move the last audio frame to the play buffer. */
 					if (CopyAudio(vqap) == VQAERR_SLEEPING) {
-						vqabuf->Flags |= VQADATF_LSLEEP;
+						loader->Sleeping = 1;
 						return (VQAERR_SLEEPING);
 					} else {
-						vqabuf->Flags &= (~VQADATF_LSLEEP);
+						loader->Sleeping = 0;
 					}
 
 					/* Load an uncompressed audio frame. */
@@ -889,10 +911,10 @@ long VQA_LoadFrame(VQAHandle *vqa)
 
 					/* Move the last audio frame to the play buffer. */
 					if (CopyAudio(vqap) == VQAERR_SLEEPING) {
-						vqabuf->Flags |= VQADATF_LSLEEP;
+						loader->Sleeping = 1;
 						return (VQAERR_SLEEPING);
 					} else {
-						vqabuf->Flags &= (~VQADATF_LSLEEP);
+						loader->Sleeping = 0;
 					}
 
 					/* Load a compressed audio frame. */
@@ -912,10 +934,10 @@ long VQA_LoadFrame(VQAHandle *vqa)
 
 					/* Move the last audio frame to the play buffer. */
 					if (CopyAudio(vqap) == VQAERR_SLEEPING) {
-						vqabuf->Flags |= VQADATF_LSLEEP;
+						loader->Sleeping = 1;
 						return (VQAERR_SLEEPING);
 					} else {
-						vqabuf->Flags &= (~VQADATF_LSLEEP);
+						loader->Sleeping = 0;
 					}
 
 					/* Load a compressed audio frame. */
@@ -941,10 +963,10 @@ long VQA_LoadFrame(VQAHandle *vqa)
 
 					/* Move the last audio frame to the play buffer. */
 					if (CopyAudio(vqap) == VQAERR_SLEEPING) {
-						vqabuf->Flags |= VQADATF_LSLEEP;
+						loader->Sleeping = 1;
 						return (VQAERR_SLEEPING);
 					} else {
-						vqabuf->Flags &= (~VQADATF_LSLEEP);
+						loader->Sleeping = 0;
 					}
 
 					/* Load a compressed audio frame. */
@@ -964,10 +986,10 @@ long VQA_LoadFrame(VQAHandle *vqa)
 
 					/* Move the last audio frame to the play buffer. */
 					if (CopyAudio(vqap) == VQAERR_SLEEPING) {
-						vqabuf->Flags |= VQADATF_LSLEEP;
+						loader->Sleeping = 1;
 						return (VQAERR_SLEEPING);
 					} else {
-						vqabuf->Flags &= (~VQADATF_LSLEEP);
+						loader->Sleeping = 0;
 					}
 
 					/* Load a compressed audio frame. */
@@ -1009,8 +1031,21 @@ long VQA_LoadFrame(VQAHandle *vqa)
 	/* Update data for mono output */
 	loader->LastFrameNum = loader->CurFrameNum;
 
-	/* Loader is finished with this frame; tell Drawer to draw it */
-	curframe->Flags |= VQAFRMF_LOADED;
+	/* Loader is finished with this frame; tell Drawer to draw it. A Loader
+	 * thread expands the frame first so the Drawer never writes the flags of
+	 * a frame node while the Loader might be reading them.
+	 */
+	if (vqap->Threaded) {
+		Expand_Frame(vqabuf, curframe);
+		pthread_mutex_lock(&vqap->LoadLock);
+		curframe->Flags |= VQAFRMF_LOADED;
+		curframe->Ready = 1;
+		pthread_cond_broadcast(&vqap->LoadCond);
+		pthread_mutex_unlock(&vqap->LoadLock);
+	} else {
+		curframe->Flags |= VQAFRMF_LOADED;
+	}
+
 	loader->CurFrame = curframe->Next;
 
 	return (0);
@@ -1070,6 +1105,9 @@ long VQA_SeekFrame(VQAHandle *vqa, long framenum, long fromwhere)
 	#endif
 
 	fromwhere = fromwhere;
+
+	/* Seeking rewinds the Loader; VQA_Play() restarts the thread. */
+	VQA_StopLoader(vqap);
 	
 	#if(VQAAUDIO_ON)
 	audio = &vqabuf->Audio;
@@ -1231,6 +1269,235 @@ long VQA_SeekFrame(VQAHandle *vqa, long framenum, long fromwhere)
 }
 
 
+/****************************************************************************
+*
+* NAME
+*     VQA_StartLoader - Start loading frames on a background thread.
+*
+* SYNOPSIS
+*     Error = VQA_StartLoader(VQAP)
+*
+*     long VQA_StartLoader(VQAHandleP *);
+*
+* FUNCTION
+*     Hand the Loader over to a thread that calls VQA_LoadFrame() and
+*     expands each frame's codebook, palette and pointers ahead of the
+*     Drawer, up to Config.PrefetchDepth frames. From then on the
+*     VQAFRMF_LOADED hand-off goes through VQA_FrameReady() and
+*     VQA_ReleaseFrame(). If the thread can't be created the player keeps
+*     loading from VQA_Play().
+*
+* INPUTS
+*     VQAP - Pointer to private VQA handle.
+*
+* RESULT
+*     Error - 0 if successful, or -1 if the thread could not be started.
+*
+****************************************************************************/
+
+long VQA_StartLoader(VQAHandleP *vqap)
+{
+	VQAFrameNode *frame;
+	long         i;
+
+	if (vqap->Threaded) {
+		return (0);
+	}
+
+	/* Frames primed before the thread existed still need expanding. */
+	frame = vqap->VQABuf->FrameData;
+
+	for (i = 0; i < vqap->Config.NumFrameBufs; i++) {
+		frame->Ready = (frame->Flags & VQAFRMF_LOADED);
+
+		if (frame->Ready) {
+			Expand_Frame(vqap->VQABuf, frame);
+		}
+
+		frame = frame->Next;
+	}
+
+	if (pthread_mutex_init(&vqap->LoadLock, NULL) != 0) {
+		return (-1);
+	}
+
+	if (pthread_cond_init(&vqap->LoadCond, NULL) != 0) {
+		pthread_mutex_destroy(&vqap->LoadLock);
+		return (-1);
+	}
+
+	vqap->LoadState = VQALOAD_RUNNING;
+	vqap->Threaded = 1;
+
+	if (pthread_create(&vqap->LoadThread, NULL, Loader_Thread, vqap) != 0) {
+		vqap->Threaded = 0;
+		vqap->LoadState = VQALOAD_IDLE;
+		pthread_cond_destroy(&vqap->LoadCond);
+		pthread_mutex_destroy(&vqap->LoadLock);
+		return (-1);
+	}
+
+	return (0);
+}
+
+
+/****************************************************************************
+*
+* NAME
+*     VQA_StopLoader - Stop the background Loader thread.
+*
+* SYNOPSIS
+*     VQA_StopLoader(VQAP)
+*
+*     void VQA_StopLoader(VQAHandleP *);
+*
+* FUNCTION
+*     Ask the Loader thread to exit and wait for it. A frame that is being
+*     read is finished first, so the stream is left at a chunk boundary.
+*     Does nothing if no thread is running.
+*
+* INPUTS
+*     VQAP - Pointer to private VQA handle.
+*
+* RESULT
+*     NONE
+*
+****************************************************************************/
+
+void VQA_StopLoader(VQAHandleP *vqap)
+{
+	if (!vqap->Threaded) {
+		return;
+	}
+
+	pthread_mutex_lock(&vqap->LoadLock);
+	vqap->LoadState = VQALOAD_STOP;
+	pthread_cond_broadcast(&vqap->LoadCond);
+	pthread_mutex_unlock(&vqap->LoadLock);
+
+	pthread_join(vqap->LoadThread, NULL);
+	pthread_cond_destroy(&vqap->LoadCond);
+	pthread_mutex_destroy(&vqap->LoadLock);
+
+	vqap->Threaded = 0;
+	vqap->LoadState = VQALOAD_IDLE;
+}
+
+
+/****************************************************************************
+*
+* NAME
+*     VQA_LoaderDone - Check if the background Loader has finished.
+*
+* SYNOPSIS
+*     Done = VQA_LoaderDone(VQAP)
+*
+*     long VQA_LoaderDone(VQAHandleP *);
+*
+* FUNCTION
+*     The Loader thread is done once it has handed over the last frame or
+*     hit a read error; VQA_Play() uses this in place of VQA_LoadFrame()'s
+*     return code to set VQADATF_LDONE.
+*
+* INPUTS
+*     VQAP - Pointer to private VQA handle.
+*
+* RESULT
+*     Done - 1 if the Loader thread has finished, 0 if it is still loading.
+*
+****************************************************************************/
+
+long VQA_LoaderDone(VQAHandleP *vqap)
+{
+	long done;
+
+	pthread_mutex_lock(&vqap->LoadLock);
+	done = (vqap->LoadState != VQALOAD_RUNNING);
+	pthread_mutex_unlock(&vqap->LoadLock);
+
+	return (done);
+}
+
+
+/****************************************************************************
+*
+* NAME
+*     VQA_FrameReady - Check if a frame has been handed to the Drawer.
+*
+* SYNOPSIS
+*     Ready = VQA_FrameReady(VQAP, Frame)
+*
+*     long VQA_FrameReady(VQAHandleP *, VQAFrameNode *);
+*
+* FUNCTION
+*     Test VQAFRMF_LOADED. If a Loader thread is running, test the frame's
+*     Ready copy of it under the Loader lock instead, so the caller neither
+*     races the Loader on the flags of a frame it is filling nor sees a
+*     loaded frame before its data.
+*
+* INPUTS
+*     VQAP  - Pointer to private VQA handle.
+*     Frame - Frame node to test.
+*
+* RESULT
+*     Ready - Nonzero if the frame is loaded.
+*
+****************************************************************************/
+
+long VQA_FrameReady(VQAHandleP *vqap, VQAFrameNode *frame)
+{
+	long ready;
+
+	if (!vqap->Threaded) {
+		return (frame->Flags & VQAFRMF_LOADED);
+	}
+
+	pthread_mutex_lock(&vqap->LoadLock);
+	ready = frame->Ready;
+	pthread_mutex_unlock(&vqap->LoadLock);
+
+	return (ready);
+}
+
+
+/****************************************************************************
+*
+* NAME
+*     VQA_ReleaseFrame - Hand a drawn frame back to the Loader.
+*
+* SYNOPSIS
+*     VQA_ReleaseFrame(VQAP, Frame)
+*
+*     void VQA_ReleaseFrame(VQAHandleP *, VQAFrameNode *);
+*
+* FUNCTION
+*     Clear the frame's flags, marking it loadable, and wake the Loader
+*     thread if one is waiting on a free buffer.
+*
+* INPUTS
+*     VQAP  - Pointer to private VQA handle.
+*     Frame - Frame node to release.
+*
+* RESULT
+*     NONE
+*
+****************************************************************************/
+
+void VQA_ReleaseFrame(VQAHandleP *vqap, VQAFrameNode *frame)
+{
+	if (!vqap->Threaded) {
+		frame->Flags = 0L;
+		return;
+	}
+
+	pthread_mutex_lock(&vqap->LoadLock);
+	frame->Flags = 0L;
+	frame->Ready = 0;
+	pthread_cond_broadcast(&vqap->LoadCond);
+	pthread_mutex_unlock(&vqap->LoadLock);
+}
+
+
 /****************************************************************************
 *
 * NAME
@@ -1728,6 +1995,163 @@ long PrimeBuffers(VQAHandle *vqa)
 }
 
 
+/****************************************************************************
+*
+* NAME
+*     Loader_Thread - Background Loader thread body.
+*
+* SYNOPSIS
+*     Loader_Thread(VQAP)
+*
+*     void *Loader_Thread(void *);
+*
+* FUNCTION
+*     Load frames while a buffer is free and fewer than PrefetchDepth
+*     frames are waiting to be drawn; otherwise sleep on LoadCond until the
+*     Drawer releases one. When the Loader is waiting on the audio it backs
+*     off for a millisecond rather than spinning.
+*
+* INPUTS
+*     VQAP - Pointer to private VQA handle.
+*
+* RESULT
+*     NULL
+*
+****************************************************************************/
+
+static void *Loader_Thread(void *arg)
+{
+	VQAHandleP *vqap = (VQAHandleP *)arg;
+	VQAData    *vqabuf = vqap->VQABuf;
+	VQALoader  *loader = &vqabuf->Loader;
+	long       depth = vqap->Config.PrefetchDepth;
+	long       rc;
+
+	pthread_mutex_lock(&vqap->LoadLock);
+
+	while (vqap->LoadState == VQALOAD_RUNNING) {
+
+		/* Wait for the Drawer to free a buffer. */
+		if (loader->CurFrame->Ready
+				|| ((depth > 0) && (Frames_Ahead(vqap) >= depth))) {
+			pthread_cond_wait(&vqap->LoadCond, &vqap->LoadLock);
+			continue;
+		}
+
+		pthread_mutex_unlock(&vqap->LoadLock);
+		rc = VQA_LoadFrame((VQAHandle *)vqap);
+
+		if (rc == VQAERR_SLEEPING) {
+			usleep(1000);
+		}
+
+		pthread_mutex_lock(&vqap->LoadLock);
+
+		if (rc == 0) {
+			vqabuf->LoadedFrames++;
+		} else if ((rc != VQAERR_NOBUFFER) && (rc != VQAERR_SLEEPING)) {
+			if (vqap->LoadState == VQALOAD_RUNNING) {
+				vqap->LoadState = VQALOAD_DONE;
+			}
+		}
+	}
+
+	pthread_mutex_unlock(&vqap->LoadLock);
+
+	return (NULL);
+}
+
+
+/****************************************************************************
+*
+* NAME
+*     Frames_Ahead - Count the frames loaded but not yet drawn.
+*
+* SYNOPSIS
+*     Count = Frames_Ahead(VQAP)
+*
+*     long Frames_Ahead(VQAHandleP *);
+*
+* FUNCTION
+*     Walk the frame ring counting Ready nodes. The caller must hold
+*     LoadLock.
+*
+* INPUTS
+*     VQAP - Pointer to private VQA handle.
+*
+* RESULT
+*     Count - Number of loaded frames.
+*
+****************************************************************************/
+
+static long Frames_Ahead(VQAHandleP *vqap)
+{
+	VQAFrameNode *frame;
+	long         count = 0;
+	long         i;
+
+	frame = vqap->VQABuf->FrameData;
+
+	for (i = 0; i < vqap->Config.NumFrameBufs; i++) {
+		if (frame->Ready) {
+			count++;
+		}
+
+		frame = frame->Next;
+	}
+
+	return (count);
+}
+
+
+/****************************************************************************
+*
+* NAME
+*     Expand_Frame - Uncompress a frame's data before it is handed over.
+*
+* SYNOPSIS
+*     Expand_Frame(VQABuf, Frame)
+*
+*     void Expand_Frame(VQAData *, VQAFrameNode *);
+*
+* FUNCTION
+*     Does the LCW work of the Drawer's Prepare_Frame() on the Loader
+*     thread, so the Drawer only has to UnVQ. The frame's codebook can
+*     only still be compressed if this is the first frame to use it.
+*
+* INPUTS
+*     VQABuf - Pointer to VQAData structure.
+*     Frame  - Frame node that has just been loaded.
+*
+* RESULT
+*     NONE
+*
+****************************************************************************/
+
+static void Expand_Frame(VQAData *vqabuf, VQAFrameNode *frame)
+{
+	VQACBNode *codebook = frame->Codebook;
+
+	if (codebook->Flags & VQACBF_CBCOMP) {
+		LCW_Uncompress((char *)codebook->Buffer + codebook->CBOffset,
+				(char *)codebook->Buffer, vqabuf->Max_CB_Size);
+		codebook->Flags &= ~VQACBF_CBCOMP;
+	}
+
+	if (frame->Flags & VQAFRMF_PALCOMP) {
+		frame->PaletteSize = LCW_Uncompress((char *)frame->Palette
+				+ frame->PalOffset, (char *)frame->Palette, vqabuf->Max_Pal_Size);
+		frame->Flags &= ~VQAFRMF_PALCOMP;
+	}
+
+	if (frame->Flags & VQAFRMF_PTRCOMP) {
+		LCW_Uncompress((char *)frame->Pointers + frame->PtrOffset,
+				(char *)frame->Pointers, vqabuf->Max_Ptr_Size);
+		frame->Flags &= ~VQAFRMF_PTRCOMP;
+	}
+}
+
+
 /****************************************************************************
 *
 * NAME
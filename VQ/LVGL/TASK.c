@@ -253,6 +253,15 @@ long VQA_Play(VQAHandle *vqa, long mode)
 		vqabuf->Flags |= VQADATF_PRIMED;
 	}
 
+	/* Hand the Loader to a background thread if requested. This is also
+	 * where it is restarted after VQA_SeekFrame(). If the thread can't be
+	 * started the frames are loaded below as usual.
+	 */
+	if ((config->LoaderThreads > 0) && !((VQAHandleP *)vqa)->Threaded
+			&& !(vqabuf->Flags & VQADATF_LDONE)) {
+		VQA_StartLoader((VQAHandleP *)vqa);
+	}
+
 	/* Main Player Loop */
 	switch (mode) {
 		case VQAMODE_PAUSE:
@@ -294,7 +303,13 @@ long VQA_Play(VQAHandle *vqa, long mode)
 					!= (VQADATF_DDONE|VQADATF_LDONE)) {
 
 				/* Load a frame */
-				if (!(vqabuf->Flags & VQADATF_LDONE)) {
+				if (((VQAHandleP *)vqa)->Threaded) {
+					if (!(vqabuf->Flags & VQADATF_LDONE)
+							&& VQA_LoaderDone((VQAHandleP *)vqa)) {
+						vqabuf->Flags |= VQADATF_LDONE;
+					}
+				}
+				else if (!(vqabuf->Flags & VQADATF_LDONE)) {
 					if ((rc = VQA_LoadFrame(vqa)) == 0) {
 						vqabuf->LoadedFrames++;
 					}
@@ -319,8 +334,13 @@ long VQA_Play(VQAHandle *vqa, long mode)
 					}
 				} else {
 					vqabuf->Flags |= VQADATF_DDONE;
-					drawer->CurFrame->Flags = 0L;
-					drawer->CurFrame = drawer->CurFrame->Next;
+
+					/* Don't pass a frame the Loader thread is still filling. */
+					if (!((VQAHandleP *)vqa)->Threaded
+							|| VQA_FrameReady((VQAHandleP *)vqa, drawer->CurFrame)) {
+						VQA_ReleaseFrame((VQAHandleP *)vqa, drawer->CurFrame);
+						drawer->CurFrame = drawer->CurFrame->Next;
+					}
 				}
 
 				/* Update Mono output */
@@ -554,7 +574,7 @@ long User_Update(VQAHandle *vqa)
 		vqabuf->Flipper.LastFrameNum = vqabuf->Flipper.CurFrame->FrameNum;
 
 		/* Mark the frame as loadable */
-		vqabuf->Flipper.CurFrame->Flags = 0L;
+		VQA_ReleaseFrame((VQAHandleP *)vqa, vqabuf->Flipper.CurFrame);
 		vqabuf->Flags &= (~VQADATF_UPDATE);
 	}
 
@@ -157,6 +157,12 @@
  * Language       - Language identifier. (Not used)
  * CapFont        - Pointer to font to use for subtitle text captions.
  * EVAFont        - Pointer to font to use for E.V.A text cations. (For C&C)
+ * LoaderThreads  - Number of background Loader threads. (0 = load from
+ *                  VQA_Play(); only one thread is used, as the stream is
+ *                  read sequentially)
+ * PrefetchDepth  - Maximum number of frames the Loader thread may hold
+ *                  loaded ahead of the Drawer. (0 = limited only by
+ *                  NumFrameBufs)
  */
 typedef struct _VQAConfig {
 	long          (*DrawerCallback)(unsigned char *screen, long framenum);
@@ -189,6 +195,8 @@ typedef struct _VQAConfig {
 	long          Language;
 	char          *CapFont;
 	char          *EVAFont; /* For C&C Only */
+	long          LoaderThreads;
+	long          PrefetchDepth;
 } VQAConfig;
 
 /* Drawer Configuration flags (DrawFlags) */
@@ -52,6 +52,7 @@
 #include "vqafile.h"
 #include "vqaplay.h"
 #include "caption.h"
+#include <pthread.h>
 
 #if(VQAAUDIO_ON)
 #include "sos.h"
@@ -155,6 +156,9 @@ typedef struct _VQACBNode {
  * PtrOffset   - Offset into buffer of the compressed vector pointer data.
  * PalOffset   - Offset into buffer of the compressed palette data.
  * PaletteSize - Size of the palette for this frame (in bytes).
+ * Ready       - Copy of VQAFRMF_LOADED kept under LoadLock when a Loader
+ *               thread is running; the Loader sets the other Flags bits
+ *               without the lock while it fills the frame.
  */
 typedef struct _VQAFrameNode {
 	unsigned char        *Pointers;
@@ -166,6 +170,7 @@ typedef struct _VQAFrameNode {
 	long                 PtrOffset;
 	long                 PalOffset;
 	long                 PaletteSize;
+	long                 Ready;
 } VQAFrameNode;
 
 /* FrameNode flags */
@@ -197,6 +202,9 @@ typedef struct _VQAFrameNode {
  * FrameSize     - Size of the last frame in bytes.
  * MaxFrameSize  - Size of the largest frame in the animation.
  * CurChunkHdr   - Chunk header of the chunk currently being processed.
+ * Sleeping      - Loader is waiting on the audio to resume a chunk. (Kept
+ *                 here rather than in VQAData Flags so a Loader thread does
+ *                 not share that word with the Drawer.)
  */
 typedef struct _VQALoader {
 	VQACBNode    *CurCB;
@@ -212,6 +220,7 @@ typedef struct _VQALoader {
 	long         FrameSize;
 	long         MaxFrameSize;
 	ChunkHeader  CurChunkHdr;
+	long         Sleeping;
 } VQALoader;
 
 
@@ -462,12 +471,20 @@ typedef struct _VQAData {
  *             VQA_Alloc() and freed through VQA_Free(). This is the only
  *             legal way to obtain and dispose of a VQAHandle.
  *
- * VQAio     - Something meaningful to the IO manager. (See DOCS)
- * IOHandler - IO handler callback.
- * VQABuf    - Pointer to internal data buffers.
- * Config    - Configuration structure.
- * Header    - VQA header structure.
- * vocfh     - Override audiotrack file handle.
+ * VQAio      - Something meaningful to the IO manager. (See DOCS)
+ * IOHandler  - IO handler callback.
+ * VQABuf     - Pointer to internal data buffers.
+ * Config     - Configuration structure.
+ * Header     - VQA header structure.
+ * vocfh      - Override audiotrack file handle.
+ * Caption    - Subtitle caption stream.
+ * EVA        - E.V.A caption stream.
+ * Threaded   - Frames are loaded by LoadThread. (Only changed while no
+ *              Loader thread is running)
+ * LoadState  - State of the Loader thread (VQALOAD_???).
+ * LoadThread - Background Loader thread.
+ * LoadLock   - Guards LoadState and the frames' Ready flags.
+ * LoadCond   - Signalled whenever a frame is loaded or released.
  */
 typedef struct _VQAHandleP {
 	unsigned long VQAio;
@@ -479,8 +496,19 @@ typedef struct _VQAHandleP {
 	long          vocfh;
 	CaptionInfo   *Caption;
 	CaptionInfo   *EVA;
+	long          Threaded;
+	long          LoadState;
+	pthread_t     LoadThread;
+	pthread_mutex_t LoadLock;
+	pthread_cond_t  LoadCond;
 } VQAHandleP;
 
+/* Loader thread states (LoadState) */
+#define VQALOAD_IDLE    0 /* No Loader thread. */
+#define VQALOAD_RUNNING 1 /* Loading frames ahead of the Drawer. */
+#define VQALOAD_DONE    2 /* Reached the end of the stream or an error. */
+#define VQALOAD_STOP    3 /* Asked to exit by VQA_StopLoader(). */
+
 
 /*---------------------------------------------------------------------------
  * FUNCTION PROTOTYPES
@@ -488,6 +516,11 @@ typedef struct _VQAHandleP {
 
 /* Loader/Drawer system. */
 long VQA_LoadFrame(VQAHandle *vqa);
+long VQA_StartLoader(VQAHandleP *vqap);
+void VQA_StopLoader(VQAHandleP *vqap);
+long VQA_LoaderDone(VQAHandleP *vqap);
+long VQA_FrameReady(VQAHandleP *vqap, VQAFrameNode *frame);
+void VQA_ReleaseFrame(VQAHandleP *vqap, VQAFrameNode *frame);
 void VQA_Configure_Drawer(VQAHandleP *vqap);
 long User_Update(VQAHandle *vqa);
 
@@ -36,7 +36,7 @@ static long Select_Frame(VQAHandleP *vqap)
     long         curtime;
     long         desiredframe;
 
-    if((curframe->Flags & VQAFRMF_LOADED) == 0) {
+    if(!VQA_FrameReady(vqap, curframe)) {
         drawer->WaitsOnLoader++;
         return VQAERR_NOBUFFER;
     }
@@ -68,7 +68,7 @@ static long Select_Frame(VQAHandleP *vqap)
     }
 
     while(1) {
-        if((curframe->Flags & VQAFRMF_LOADED) == 0)
+        if(!VQA_FrameReady(vqap, curframe))
             return VQAERR_NOBUFFER;
 
         if(curframe->Flags & VQAFRMF_KEY)
@@ -87,7 +87,7 @@ static long Select_Frame(VQAHandleP *vqap)
                 if(config->DrawerCallback(NULL, curframe->FrameNum) != 0)
                     return VQAERR_EOF;
             }
-            curframe->Flags = 0L;
+            VQA_ReleaseFrame(vqap, curframe);
             curframe = curframe->Next;
             drawer->CurFrame = curframe;
             drawer->NumSkipped++;
@@ -151,8 +151,10 @@ long DrawFrame_Buffer(VQAHandle *vqa)
         vqabuf->Flags &= ~VQADATF_DSLEEP;
     }
 
+    /* Draw into the back buffer and show it; the next frame may still be
+     * in the hands of the Loader. */
     curframe = drawer->CurFrame;
-    buff = (unsigned char *)frame_desc->data + sizeof(vq_raw_image_t);
+    buff = next_frame_data + sizeof(vq_raw_image_t);
 
     vqabuf->UnVQ(curframe->Codebook->Buffer, curframe->Pointers, buff,
                  drawer->BlocksPerRow, drawer->NumRows, drawer->ImageWidth);
@@ -162,12 +164,11 @@ long DrawFrame_Buffer(VQAHandle *vqa)
     vqabuf->Flags |= VQADATF_UPDATE;
 
     if(config->DrawerCallback) {
-        if(config->DrawerCallback((unsigned char *)frame_desc->data + sizeof(vq_raw_image_t), curframe->FrameNum) != 0)
+        if(config->DrawerCallback(buff, curframe->FrameNum) != 0)
             return VQAERR_EOF;
     }
 
     drawer->CurFrame = curframe->Next;
-    decode_frame_node(vqa, drawer->CurFrame, next_frame_data);
     lv_obj_invalidate(img_obj);
     swap_lvgl_buffers();
     return 0;
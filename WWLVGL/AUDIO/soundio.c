@@ -1,74 +1,587 @@
 /*
  * audio/soundio.c - portable sound driver
- * Last updated: 2025-06-24
+ * Last updated: 2026-10-17
  */
 
 /* Portable audio backend based on miniaudio. This replaces the legacy
- * DirectSound implementation with a very small mixer.
+ * DirectSound implementation with a small software mixer.
+ *
+ * Samples are decoded once (raw, Westwood or SOS ADPCM), converted to the
+ * device rate and kept in a cache keyed by the AUD pointer the game hands
+ * us.  The device callback then only has to scale, pan and sum the cached
+ * PCM, which is done in fixed size blocks with an SSE2 path when available.
+ *
+ * The game thread never touches mixer state.  Play, stop, volume and fade
+ * requests go through a single-producer/single-consumer ring that the
+ * device callback drains at the start of each buffer.  The callback
+ * publishes how far it has got, and cache buffers that are evicted are only
+ * freed once it has moved past the point where they were retired.
  */
 
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <stdatomic.h>
 #include "audio.h"
 #include "soundint.h"
 #include <ra/audio_decompress.h>
 #include <ra/miniaudio.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #ifndef TRUE
 #define TRUE 1
 #define FALSE 0
 #endif
 
+/* Number of mixer voices.  Builds such as the mixer benchmark may raise it. */
+#ifndef SOUNDIO_VOICES
+#define SOUNDIO_VOICES MAX_SFX
+#endif
+
+#define AUD_HEADER_SIZE   12        /* on-disk AUDHeaderType, packed */
+#define AUD_CHUNK_SIZE    8         /* size, uncompressed size, magic */
+#define AUD_CHUNK_MAGIC   0x0000DEAFUL
+
+#define CACHE_ENTRIES     64
+#define CACHE_BUDGET      (8L * 1024 * 1024)   /* bytes of decoded PCM */
+#define MIX_BLOCK         256                  /* frames mixed per pass */
+#define CMD_RING          256                  /* power of two */
+#define RETIRE_MAX        64
+
+/* Header fields read byte by byte; AUDHeaderType uses long, which is not
+ * 32 bits everywhere. */
 typedef struct {
-    int16_t *data;
-    long samples;
-    long pos;
-    int volume;
+    unsigned rate;
+    uint32_t size;
+    uint32_t uncomp_size;
+    uint8_t flags;
+    uint8_t compression;
+} aud_info;
+
+typedef struct {
+    void const *key;        /* AUD pointer the game played */
+    aud_info info;          /* header copy, guards against reused pointers */
+    int16_t *data;          /* interleaved PCM at the device rate */
+    long frames;
+    int channels;
+    unsigned long stamp;    /* last use, for LRU eviction */
+} cache_entry;
+
+/* Game thread view of a voice. */
+typedef struct {
+    cache_entry *entry;
+    unsigned gen;           /* bumped on every play */
     int active;
 } ma_slot;
 
-static ma_slot slots[MAX_SFX];
+/* Mixer thread voice.  The PCM description is copied out of the cache
+ * entry so the callback never reads cache bookkeeping. */
+typedef struct {
+    const int16_t *data;
+    long frames;
+    int channels;
+    long pos;               /* next frame to mix */
+    int volume;             /* 0..255 */
+    int pan;                /* -32767 left .. 32767 right */
+    long fade_left;         /* frames until silent, 0 when not fading */
+    long fade_total;
+    unsigned gen;
+    int active;
+} ma_voice;
+
+enum { CMD_PLAY, CMD_STOP, CMD_VOLUME, CMD_FADE };
+
+typedef struct {
+    int type;
+    int slot;
+    unsigned gen;
+    const int16_t *data;
+    long frames;
+    int channels;
+    int volume;
+    int pan;
+    long ticks;
+} mix_cmd;
+
+/* Evicted PCM waiting for the mixer to pass ring position 'seq'. */
+typedef struct {
+    int16_t *data;
+    unsigned seq;
+} retired_buf;
+
+static ma_slot slots[SOUNDIO_VOICES];
+static cache_entry cache[CACHE_ENTRIES];
+static long cache_bytes;
+static unsigned long cache_clock;
+static retired_buf retired[RETIRE_MAX];
+static int retired_count;
 static int g_channels = 2;
 static unsigned int g_rate = 22050;
+static int g_sound_vol = 255;
+static int g_score_vol = 255;
 
-static void mix_callback(void *output, unsigned int frame_count)
+static mix_cmd ring[CMD_RING];
+static atomic_uint ring_head;                   /* written by the game */
+static atomic_uint ring_tail;                   /* written by the mixer */
+static atomic_uint done_gen[SOUNDIO_VOICES];    /* written by the mixer */
+
+/* Owned by the mixer thread. */
+static ma_voice voices[SOUNDIO_VOICES];
+static int mix_master = 255;
+static int32_t mix_acc[MIX_BLOCK * 2];
+
+static uint32_t read_le32(const uint8_t *p)
 {
-    int16_t *out = (int16_t *)output;
-    memset(out, 0, frame_count * g_channels * sizeof(int16_t));
-    for (int i = 0; i < MAX_SFX; ++i) {
-        if (!slots[i].active) continue;
-        for (unsigned int f = 0; f < frame_count; ++f) {
-            if (slots[i].pos >= slots[i].samples) {
-                slots[i].active = 0;
-                break;
-            }
-            int16_t s = slots[i].data[slots[i].pos++] * slots[i].volume / 255;
-            for (int c = 0; c < g_channels; ++c) {
-                long val = out[f * g_channels + c] + s;
-                if (val > 32767) val = 32767;
-                if (val < -32768) val = -32768;
-                out[f * g_channels + c] = (int16_t)val;
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void read_header(void const *sample, aud_info *info)
+{
+    const uint8_t *p = (const uint8_t *)sample;
+    info->rate = (unsigned)p[0] | ((unsigned)p[1] << 8);
+    info->size = read_le32(p + 2);
+    info->uncomp_size = read_le32(p + 6);
+    info->flags = p[10];
+    info->compression = p[11];
+}
+
+/* ---- Decoding -------------------------------------------------------- */
+
+/* Walk the chunk stream of a Westwood or SOS compressed sample.  Output is
+ * 8-bit unsigned for Westwood and 16-bit signed for SOS, exactly as the
+ * original Sample_Copy produced it. */
+static long decode_chunks(const aud_info *info, const uint8_t *src,
+                          uint8_t *dest, long dest_size)
+{
+    _SOS_COMPRESS_INFO sos;
+    const uint8_t *end = src + info->size;
+    long out = 0;
+
+    memset(&sos, 0, sizeof(sos));
+    sos.wBitSize = 16;
+    sos.wChannels = 1;
+    sosCODECInitStream(&sos);
+
+    while (end - src >= AUD_CHUNK_SIZE) {
+        unsigned fsize = (unsigned)src[0] | ((unsigned)src[1] << 8);
+        unsigned dsize = (unsigned)src[2] | ((unsigned)src[3] << 8);
+        if (read_le32(src + 4) != AUD_CHUNK_MAGIC) break;
+        src += AUD_CHUNK_SIZE;
+        if (end - src < (long)fsize || dest_size - out < (long)dsize) break;
+
+        if (fsize == dsize) {
+            memcpy(dest + out, src, dsize);
+        } else if (info->compression == SCOMP_WESTWOOD) {
+            aud_decompress_frame((void *)src, dest + out, dsize);
+        } else {
+            /* Each ADPCM byte carries two 16-bit samples. */
+            if ((long)fsize * 4 < (long)dsize) dsize = fsize * 4;
+            sos.lpSource = (char *)src;
+            sos.lpDest = (char *)(dest + out);
+            sosCODECDecompressData(&sos, dsize / 4);
+        }
+        src += fsize;
+        out += dsize;
+    }
+    return out;
+}
+
+/* Linear interpolation from the sample rate to the device rate. */
+static int16_t *resample(int16_t *in, long in_frames, int channels,
+                         unsigned src_rate, long *out_frames)
+{
+    if (src_rate == 0 || src_rate == g_rate || in_frames < 2) {
+        *out_frames = in_frames;
+        return in;
+    }
+
+    long frames = (long)(((int64_t)in_frames * g_rate) / src_rate);
+    int16_t *out = (int16_t *)malloc((size_t)(frames ? frames : 1) * channels * sizeof(int16_t));
+    if (!out) {
+        free(in);
+        return NULL;
+    }
+
+    uint64_t step = ((uint64_t)src_rate << 16) / g_rate;
+    uint64_t pos = 0;
+    for (long f = 0; f < frames; ++f, pos += step) {
+        long i = (long)(pos >> 16);
+        int frac = (int)(pos & 0xFFFF);
+        long j = (i + 1 < in_frames) ? i + 1 : i;
+        for (int c = 0; c < channels; ++c) {
+            int a = in[i * channels + c];
+            int b = in[j * channels + c];
+            out[f * channels + c] = (int16_t)(a + (((b - a) * frac) >> 16));
+        }
+    }
+    free(in);
+    *out_frames = frames;
+    return out;
+}
+
+/* Decode a complete AUD sample to 16-bit PCM at the device rate. */
+static int decode_sample(void const *sample, const aud_info *info, cache_entry *e)
+{
+    const uint8_t *src = (const uint8_t *)sample + AUD_HEADER_SIZE;
+    int bytes_per_sample = (info->flags & AUD_FLAG_16BIT) ? 2 : 1;
+    int channels = (info->flags & AUD_FLAG_STEREO) ? 2 : 1;
+    long raw_size;
+    uint8_t *raw;
+
+    switch (info->compression) {
+    case SCOMP_NONE:
+        raw_size = info->size;
+        raw = (uint8_t *)src;
+        break;
+    case SCOMP_WESTWOOD:
+    case SCOMP_SOS:
+        /* The SOS C decoder only handles 16-bit mono streams. */
+        if (info->compression == SCOMP_SOS && (bytes_per_sample != 2 || channels != 1))
+            return -1;
+        raw = (uint8_t *)malloc(info->uncomp_size ? info->uncomp_size : 1);
+        if (!raw) return -1;
+        raw_size = decode_chunks(info, src, raw, info->uncomp_size);
+        break;
+    default:
+        return -1;
+    }
+
+    long samples = raw_size / bytes_per_sample;
+    long frames = samples / channels;
+    int16_t *pcm = (int16_t *)malloc((size_t)(frames ? frames : 1) * channels * sizeof(int16_t));
+    if (pcm) {
+        if (bytes_per_sample == 1) {
+            for (long i = 0; i < frames * channels; ++i)
+                pcm[i] = (int16_t)(((int)raw[i] - 128) * 256);
+        } else {
+            memcpy(pcm, raw, (size_t)frames * channels * sizeof(int16_t));
+        }
+    }
+    if (raw != src) free(raw);
+    if (!pcm) return -1;
+
+    pcm = resample(pcm, frames, channels, info->rate, &frames);
+    if (!pcm) return -1;
+
+    e->data = pcm;
+    e->frames = frames;
+    e->channels = channels;
+    return 0;
+}
+
+/* ---- Sample cache ---------------------------------------------------- */
+
+static int slot_playing(int i)
+{
+    return slots[i].active &&
+           atomic_load_explicit(&done_gen[i], memory_order_acquire) != slots[i].gen;
+}
+
+static int entry_in_use(const cache_entry *e)
+{
+    for (int i = 0; i < SOUNDIO_VOICES; ++i)
+        if (slots[i].entry == e && slot_playing(i)) return 1;
+    return 0;
+}
+
+/* Free retired buffers the mixer can no longer be reading. */
+static void reclaim(void)
+{
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+    for (int i = 0; i < retired_count; ) {
+        if ((int)(tail - retired[i].seq) >= 0) {
+            free(retired[i].data);
+            retired[i] = retired[--retired_count];
+        } else {
+            ++i;
+        }
+    }
+}
+
+/* Drop an entry from the cache.  Its PCM may still be referenced by a
+ * callback that has not yet applied the stop, so it is parked until the
+ * mixer has consumed every command posted so far. */
+static int entry_retire(cache_entry *e)
+{
+    if (e->data) {
+        if (retired_count == RETIRE_MAX) reclaim();
+        if (retired_count == RETIRE_MAX) return -1;
+        retired[retired_count].data = e->data;
+        retired[retired_count].seq = atomic_load_explicit(&ring_head, memory_order_relaxed);
+        ++retired_count;
+        cache_bytes -= e->frames * e->channels * (long)sizeof(int16_t);
+    }
+    memset(e, 0, sizeof(*e));
+    return 0;
+}
+
+/* Only safe while the device is stopped. */
+static void cache_clear(void)
+{
+    for (int i = 0; i < CACHE_ENTRIES; ++i) free(cache[i].data);
+    for (int i = 0; i < retired_count; ++i) free(retired[i].data);
+    memset(cache, 0, sizeof(cache));
+    cache_bytes = 0;
+    retired_count = 0;
+}
+
+/* Least recently used entry that no voice is playing, or NULL. */
+static cache_entry *cache_victim(void)
+{
+    cache_entry *victim = NULL;
+    for (int i = 0; i < CACHE_ENTRIES; ++i) {
+        cache_entry *e = &cache[i];
+        if (!e->key || entry_in_use(e)) continue;
+        if (!victim || e->stamp < victim->stamp) victim = e;
+    }
+    return victim;
+}
+
+static cache_entry *cache_fetch(void const *sample)
+{
+    aud_info info;
+    cache_entry *slot = NULL;
+
+    reclaim();
+    read_header(sample, &info);
+    for (int i = 0; i < CACHE_ENTRIES; ++i) {
+        cache_entry *e = &cache[i];
+        if (e->key == sample) {
+            if (!memcmp(&e->info, &info, sizeof(info))) {
+                e->stamp = ++cache_clock;
+                return e;
             }
+            /* Same address, different sample: the buffer was reloaded. */
+            if (entry_in_use(e) || entry_retire(e) != 0) return NULL;
+        }
+        if (!e->key && !slot) slot = e;
+    }
+
+    cache_entry fresh;
+    memset(&fresh, 0, sizeof(fresh));
+    if (decode_sample(sample, &info, &fresh) != 0) return NULL;
+    long bytes = fresh.frames * fresh.channels * (long)sizeof(int16_t);
+
+    while (!slot || cache_bytes + bytes > CACHE_BUDGET) {
+        cache_entry *victim = cache_victim();
+        if (!victim || entry_retire(victim) != 0) break;
+        if (!slot) slot = victim;
+    }
+    if (!slot) {
+        free(fresh.data);
+        return NULL;
+    }
+
+    fresh.key = sample;
+    fresh.info = info;
+    fresh.stamp = ++cache_clock;
+    *slot = fresh;
+    cache_bytes += bytes;
+    return slot;
+}
+
+/* ---- Mixing ---------------------------------------------------------- */
+
+/* acc[i] += src[i] * gain, gains alternating g0/g1 across the interleave. */
+static void mix_interleaved(int32_t *acc, const int16_t *src, long count,
+                            int g0, int g1)
+{
+    long i = 0;
+#if defined(__SSE2__)
+    __m128i g = _mm_set_epi16((short)g1, (short)g0, (short)g1, (short)g0,
+                              (short)g1, (short)g0, (short)g1, (short)g0);
+    for (; i + 8 <= count; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i lo = _mm_mullo_epi16(s, g);
+        __m128i hi = _mm_mulhi_epi16(s, g);
+        __m128i *a = (__m128i *)(acc + i);
+        _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), _mm_unpacklo_epi16(lo, hi)));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), _mm_unpackhi_epi16(lo, hi)));
+    }
+#endif
+    for (; i + 2 <= count; i += 2) {
+        acc[i] += src[i] * g0;
+        acc[i + 1] += src[i + 1] * g1;
+    }
+    if (i < count) acc[i] += src[i] * g0;
+}
+
+/* Mono source into a stereo accumulator. */
+static void mix_mono_to_stereo(int32_t *acc, const int16_t *src, long frames,
+                               int gl, int gr)
+{
+    long f = 0;
+#if defined(__SSE2__)
+    __m128i g = _mm_set_epi16((short)gr, (short)gl, (short)gr, (short)gl,
+                              (short)gr, (short)gl, (short)gr, (short)gl);
+    for (; f + 8 <= frames; f += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + f));
+        __m128i d[2] = { _mm_unpacklo_epi16(s, s), _mm_unpackhi_epi16(s, s) };
+        __m128i *a = (__m128i *)(acc + f * 2);
+        for (int k = 0; k < 2; ++k) {
+            __m128i lo = _mm_mullo_epi16(d[k], g);
+            __m128i hi = _mm_mulhi_epi16(d[k], g);
+            _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), _mm_unpacklo_epi16(lo, hi)));
+            ++a;
+            _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), _mm_unpackhi_epi16(lo, hi)));
+            ++a;
+        }
+    }
+#endif
+    for (; f < frames; ++f) {
+        acc[f * 2] += src[f] * gl;
+        acc[f * 2 + 1] += src[f] * gr;
+    }
+}
+
+/* Scale the accumulator back down and saturate to 16 bits. */
+static void clip_block(int16_t *out, const int32_t *acc, long count)
+{
+    long i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(acc + i)), 8);
+        __m128i b = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(acc + i + 4)), 8);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packs_epi32(a, b));
+    }
+#endif
+    for (; i < count; ++i) {
+        int32_t v = acc[i] >> 8;
+        if (v > 32767) v = 32767;
+        if (v < -32768) v = -32768;
+        out[i] = (int16_t)v;
+    }
+}
+
+static void voice_done(int i)
+{
+    voices[i].active = 0;
+    atomic_store_explicit(&done_gen[i], voices[i].gen, memory_order_release);
+}
+
+static void apply_cmd(const mix_cmd *c)
+{
+    ma_voice *v = &voices[c->slot >= 0 ? c->slot : 0];
+
+    switch (c->type) {
+    case CMD_PLAY:
+        v->data = c->data;
+        v->frames = c->frames;
+        v->channels = c->channels;
+        v->pos = 0;
+        v->volume = c->volume;
+        v->pan = c->pan;
+        v->fade_left = v->fade_total = 0;
+        v->gen = c->gen;
+        v->active = 1;
+        break;
+    case CMD_STOP:
+        if (v->active) voice_done(c->slot);
+        break;
+    case CMD_VOLUME:
+        mix_master = c->volume;
+        break;
+    case CMD_FADE:
+        if (v->active && !v->fade_total) {
+            v->fade_total = v->fade_left = c->ticks * (long)g_rate / 60 + 1;
         }
+        break;
+    }
+}
+
+static void mix_voice(int i, unsigned frames)
+{
+    ma_voice *v = &voices[i];
+    long left = v->frames - v->pos;
+    long n = (long)frames < left ? (long)frames : left;
+    const int16_t *src = v->data + v->pos * v->channels;
+
+    /* Gains are 8.8 fixed point: volume scaled by the master volume and any
+     * fade in progress, then attenuated on the side away from the pan
+     * position.  Fades step once per block. */
+    int gain = v->volume * mix_master / 255;
+    if (v->fade_total) gain = (int)(gain * v->fade_left / v->fade_total);
+    int gl = v->pan > 0 ? gain * (32767 - v->pan) / 32767 : gain;
+    int gr = v->pan < 0 ? gain * (32767 + v->pan) / 32767 : gain;
+
+    if (g_channels == 2) {
+        if (v->channels == 1)
+            mix_mono_to_stereo(mix_acc, src, n, gl, gr);
+        else
+            mix_interleaved(mix_acc, src, n * 2, gl, gr);
+    } else if (v->channels == 1) {
+        mix_interleaved(mix_acc, src, n, gain, gain);
+    } else {
+        for (long f = 0; f < n; ++f)
+            mix_acc[f] += ((src[f * 2] + src[f * 2 + 1]) >> 1) * gain;
+    }
+
+    v->pos += n;
+    if (v->fade_total) v->fade_left -= n;
+    if (v->pos >= v->frames || (v->fade_total && v->fade_left <= 0)) voice_done(i);
+}
+
+static void mix_callback(void *output, unsigned int frame_count)
+{
+    int16_t *out = (int16_t *)output;
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_acquire);
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+
+    for (; tail != head; ++tail) apply_cmd(&ring[tail & (CMD_RING - 1)]);
+
+    while (frame_count) {
+        unsigned n = frame_count < MIX_BLOCK ? frame_count : MIX_BLOCK;
+        memset(mix_acc, 0, n * g_channels * sizeof(int32_t));
+        for (int i = 0; i < SOUNDIO_VOICES; ++i)
+            if (voices[i].active) mix_voice(i, n);
+        clip_block(out, mix_acc, (long)n * g_channels);
+        out += n * g_channels;
+        frame_count -= n;
     }
+
+    /* Everything retired before 'tail' is now unreferenced. */
+    atomic_store_explicit(&ring_tail, tail, memory_order_release);
 }
 
-static void free_slot(int id)
+/* ---- Command ring (game thread) -------------------------------------- */
+
+/* Returns FALSE when the ring is full; the caller must leave its view of
+ * the voice unchanged so nothing is freed under the mixer. */
+static int post_cmd(const mix_cmd *c)
 {
-    if (id < 0 || id >= MAX_SFX) return;
-    free(slots[id].data);
-    memset(&slots[id], 0, sizeof(slots[id]));
+    unsigned head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+    if (head - tail >= CMD_RING) return FALSE;
+    ring[head & (CMD_RING - 1)] = *c;
+    atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+    return TRUE;
 }
 
+static void ring_reset(void)
+{
+    atomic_store(&ring_head, 0);
+    atomic_store(&ring_tail, 0);
+    for (int i = 0; i < SOUNDIO_VOICES; ++i) atomic_store(&done_gen[i], 0);
+    memset(slots, 0, sizeof(slots));
+    memset(voices, 0, sizeof(voices));
+}
+
+/* ---- Public interface ------------------------------------------------ */
+
 BOOL Audio_Init(void *window, int bits_per_sample, BOOL stereo,
                 int rate, int reverse_channels)
 {
     (void)window; (void)bits_per_sample; (void)reverse_channels;
     g_channels = stereo ? 2 : 1;
+    if ((unsigned)rate != g_rate) cache_clear();
     g_rate = rate;
     ra_timer_init();
-    memset(slots, 0, sizeof(slots));
+    ring_reset();
+    mix_master = g_sound_vol;
     return ra_audio_init(rate, g_channels, mix_callback) == 0 ? TRUE : FALSE;
 }
 
@@ -76,55 +589,46 @@ void Sound_End(void)
 {
     ra_audio_shutdown();
     ra_timer_uninit();
-    for (int i = 0; i < MAX_SFX; ++i) free_slot(i);
+    ring_reset();
+    cache_clear();
 }
 
 int Get_Free_Sample_Handle(int priority)
 {
     (void)priority;
-    for (int i = 0; i < MAX_SFX; ++i)
-        if (!slots[i].active && !slots[i].data)
+    for (int i = 0; i < SOUNDIO_VOICES; ++i)
+        if (!slot_playing(i))
             return i;
     return -1;
 }
 
-static int load_sample_data(const void *sample, int id, int volume)
+int Play_Sample_Handle(void const *sample, int priority, int volume,
+                       signed short panloc, int id)
 {
-    AUDHeaderType hdr;
-    memcpy(&hdr, sample, sizeof(hdr));
-    if (hdr.Compression != SCOMP_NONE) return -1; /* unsupported */
+    (void)priority;
+    if (!sample || id < 0 || id >= SOUNDIO_VOICES) return -1;
 
-    int bytes_per_sample = (hdr.Flags & AUD_FLAG_16BIT) ? 2 : 1;
-    int channels = (hdr.Flags & AUD_FLAG_STEREO) ? 2 : 1;
-    long frames = hdr.Size / (bytes_per_sample * channels);
-    int16_t *buf = (int16_t *)malloc(frames * channels * sizeof(int16_t));
-    if (!buf) return -1;
+    cache_entry *e = cache_fetch(sample);
+    if (!e || !e->frames) return -1;
 
-    const uint8_t *src = (const uint8_t *)sample + sizeof(hdr);
-    if (bytes_per_sample == 1) {
-        for (long i = 0; i < frames * channels; ++i)
-            buf[i] = ((int16_t)src[i] - 128) << 8;
-    } else {
-        memcpy(buf, src, frames * channels * sizeof(int16_t));
-    }
+    mix_cmd c;
+    memset(&c, 0, sizeof(c));
+    c.type = CMD_PLAY;
+    c.slot = id;
+    c.gen = slots[id].gen + 1;
+    c.data = e->data;
+    c.frames = e->frames;
+    c.channels = e->channels;
+    c.volume = volume > 255 ? 255 : (volume < 0 ? 0 : volume);
+    c.pan = panloc < -32767 ? -32767 : panloc;
+    if (!post_cmd(&c)) return -1;
 
-    free_slot(id);
-    slots[id].data = buf;
-    slots[id].samples = frames * channels;
-    slots[id].pos = 0;
-    slots[id].volume = volume;
+    slots[id].entry = e;
+    slots[id].gen = c.gen;
     slots[id].active = 1;
     return id;
 }
 
-int Play_Sample_Handle(void const *sample, int priority, int volume,
-                       signed short panloc, int id)
-{
-    (void)priority; (void)panloc;
-    if (id < 0 || id >= MAX_SFX) return -1;
-    return load_sample_data(sample, id, volume);
-}
-
 int Play_Sample(void const *sample, int priority, int volume, signed short panloc)
 {
     int id = Get_Free_Sample_Handle(priority);
@@ -134,49 +638,78 @@ int Play_Sample(void const *sample, int priority, int volume, signed short panlo
 
 void Stop_Sample(int handle)
 {
-    free_slot(handle);
+    if (handle < 0 || handle >= SOUNDIO_VOICES || !slot_playing(handle)) return;
+
+    mix_cmd c;
+    memset(&c, 0, sizeof(c));
+    c.type = CMD_STOP;
+    c.slot = handle;
+    if (post_cmd(&c)) slots[handle].active = 0;
 }
 
 BOOL Sample_Status(int handle)
 {
-    return (handle >= 0 && handle < MAX_SFX && slots[handle].active) ? TRUE : FALSE;
+    return (handle >= 0 && handle < SOUNDIO_VOICES && slot_playing(handle)) ? TRUE : FALSE;
 }
 
 BOOL Is_Sample_Playing(void const *sample)
 {
-    (void)sample; return FALSE;
+    for (int i = 0; i < SOUNDIO_VOICES; ++i)
+        if (slot_playing(i) && slots[i].entry->key == sample) return TRUE;
+    return FALSE;
 }
 
 void Stop_Sample_Playing(void const *sample)
 {
-    (void)sample;
+    for (int i = 0; i < SOUNDIO_VOICES; ++i)
+        if (slot_playing(i) && slots[i].entry->key == sample) Stop_Sample(i);
 }
 
 int Set_Sound_Vol(int volume)
 {
-    for (int i = 0; i < MAX_SFX; ++i)
-        if (slots[i].active) slots[i].volume = volume;
-    return volume;
+    int old = g_sound_vol;
+    mix_cmd c;
+    memset(&c, 0, sizeof(c));
+    c.type = CMD_VOLUME;
+    c.slot = -1;
+    c.volume = volume > 255 ? 255 : (volume < 0 ? 0 : volume);
+    if (post_cmd(&c)) g_sound_vol = c.volume;
+    return old;
 }
 
+/* No score voices are mixed yet; the level is only remembered. */
 int Set_Score_Vol(int volume)
 {
-    return Set_Sound_Vol(volume);
+    int old = g_score_vol;
+    g_score_vol = volume > 255 ? 255 : (volume < 0 ? 0 : volume);
+    return old;
 }
 
 void Fade_Sample(int handle, int ticks)
 {
-    (void)handle; (void)ticks;
+    if (!Sample_Status(handle)) return;
+    if (ticks <= 0) {
+        Stop_Sample(handle);
+        return;
+    }
+
+    mix_cmd c;
+    memset(&c, 0, sizeof(c));
+    c.type = CMD_FADE;
+    c.slot = handle;
+    c.ticks = ticks;
+    post_cmd(&c);
 }
 
 int Get_Digi_Handle(void) { return 0; }
 long Sample_Length(void const *sample)
 {
-    AUDHeaderType hdr; memcpy(&hdr, sample, sizeof(hdr));
-    int bytes = hdr.Size;
-    int bps = (hdr.Flags & AUD_FLAG_16BIT) ? 2 : 1;
-    int ch = (hdr.Flags & AUD_FLAG_STEREO) ? 2 : 1;
-    return bytes / (bps * ch);
+    aud_info info;
+    if (!sample) return 0;
+    read_header(sample, &info);
+    int bps = (info.flags & AUD_FLAG_16BIT) ? 2 : 1;
+    int ch = (info.flags & AUD_FLAG_STEREO) ? 2 : 1;
+    return (long)info.uncomp_size / (bps * ch);
 }
 
 /* Unused stubs retained for compatibility */
@@ -0,0 +1,77 @@
+#ifndef UDP_TRANSPORT_H
+#define UDP_TRANSPORT_H
+
+/*
+ * Non-blocking UDP packet transport for the Linux build.
+ *
+ * Incoming packets are drained into a fixed receive pool with one recvmmsg()
+ * call and handed out one at a time; outgoing packets are copied into a fixed
+ * send pool and written with one sendmmsg() call when the pool is flushed.
+ * Nothing is allocated once the transport is open.
+ *
+ * Each transport binds the first free port in [port, port + UDP_PORT_SPAN),
+ * so several game instances can run on one machine. A broadcast is sent to
+ * every port in that range as a real broadcast, which the kernel also
+ * delivers to the instances on this machine. Only if the broadcast is
+ * refused (no network up) is it copied to them over the loopback interface,
+ * so each instance gets exactly one copy either way.
+ *
+ * struct mmsghdr needs _GNU_SOURCE defined before the first system header.
+ */
+
+#include <stdint.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#define UDP_MAX_PACKET  1024   /* Largest payload; matches the Winsock buffers. */
+#define UDP_POOL_SIZE   64     /* Packets per direction per syscall. */
+#define UDP_PORT_SPAN   8      /* Instances that can share one machine. */
+
+typedef struct {
+    struct sockaddr_in address;
+    int length;
+    unsigned char data[UDP_MAX_PACKET];
+} udp_packet_t;
+
+typedef struct {
+    int socket;
+    int epoll;
+    unsigned short base_port;    /* Host order. */
+    unsigned short port;         /* Port actually bound, host order. */
+
+    udp_packet_t in[UDP_POOL_SIZE];
+    struct mmsghdr in_msgs[UDP_POOL_SIZE];
+    struct iovec in_iov[UDP_POOL_SIZE];
+    int in_next;
+    int in_count;
+
+    udp_packet_t out[UDP_POOL_SIZE];
+    struct mmsghdr out_msgs[UDP_POOL_SIZE];
+    struct iovec out_iov[UDP_POOL_SIZE];
+    int out_count;
+
+    unsigned long packets_in;
+    unsigned long packets_out;
+    unsigned long dropped;       /* Send failures and oversized packets. */
+    unsigned long recv_calls;
+    unsigned long send_calls;
+} udp_transport_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int  udp_transport_open(udp_transport_t *t, unsigned short port);
+void udp_transport_close(udp_transport_t *t);
+int  udp_transport_wait(udp_transport_t *t, int timeout_ms);
+int  udp_transport_drain(udp_transport_t *t);
+int  udp_transport_receive(udp_transport_t *t, void *buf, int len, struct sockaddr_in *from);
+int  udp_transport_send(udp_transport_t *t, const void *buf, int len, const struct sockaddr_in *to);
+int  udp_transport_broadcast(udp_transport_t *t, const void *buf, int len);
+int  udp_transport_flush(udp_transport_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UDP_TRANSPORT_H */
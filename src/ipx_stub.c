@@ -1,3 +1,6 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#  define _GNU_SOURCE
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -28,11 +31,24 @@ typedef int socket_t;
 #    define CLOSESOCKET close
 #  endif
 #endif
+#ifdef __linux__
+#  include <ra/udp_transport.h>
+#endif
 #include "ipx.h"
 
 
 
+#ifdef __linux__
+/*
+ * On Linux all traffic goes through a batched transport. Sends are queued and
+ * written together by IPX_Flush_Packets(), and receives are drained from the
+ * socket a pool at a time. The IPX node address of a station is its IP
+ * address followed by its port, so several stations can share one machine.
+ */
+static udp_transport_t transport = { .socket = -1, .epoll = -1 };
+#else
 static socket_t udp_socket = INVALID_SOCKET;
+#endif
 static unsigned short bound_port = 0;
 #ifdef _WIN32
 static bool wsa_initialized = false;
@@ -44,6 +60,27 @@ int IPX_SPX_Installed(void)
     return 1; /* always available */
 }
 
+#ifdef __linux__
+
+int IPX_Open_Socket(unsigned short port)
+{
+    udp_transport_close(&transport);
+    if (udp_transport_open(&transport, port) != 0) {
+        return -1;
+    }
+    bound_port = port;
+    return 0;
+}
+
+int IPX_Close_Socket(unsigned short port)
+{
+    (void)port;
+    udp_transport_close(&transport);
+    return 0;
+}
+
+#else
+
 int IPX_Open_Socket(unsigned short port)
 {
 #ifdef _WIN32
@@ -94,6 +131,8 @@ int IPX_Close_Socket(unsigned short port)
     return 0;
 }
 
+#endif /* __linux__ */
+
 int IPX_Get_Connection_Number(void)
 {
     return 1; /* stub implementation */
@@ -110,12 +149,17 @@ int IPX_Get_Internet_Address(int connection_number,
                              unsigned char *physical_node)
 {
     (void)connection_number;
+    uint32_t addr = htonl(INADDR_LOOPBACK);
     if (network_number) {
-        uint32_t addr = htonl(INADDR_LOOPBACK);
         memcpy(network_number, &addr, sizeof(addr));
     }
     if (physical_node) {
         memset(physical_node, 0, 6);
+#ifdef __linux__
+        memcpy(physical_node, &addr, sizeof(addr));
+        physical_node[4] = (unsigned char)(transport.port >> 8);
+        physical_node[5] = (unsigned char)(transport.port & 0xff);
+#endif
     }
     return 0;
 }
@@ -129,6 +173,92 @@ int IPX_Get_User_ID(int connection_number, char *user_id)
     return 0;
 }
 
+#ifdef __linux__
+
+/*
+ * Fills in the IPX header of a received packet. The sender's port goes into
+ * the last two bytes of its node address so replies find the right station.
+ */
+static void fill_header(IPXHeaderType *hdr, int len, const struct sockaddr_in *from)
+{
+    unsigned short port = ntohs(from->sin_port);
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->Length = htons((unsigned short)(len + sizeof(IPXHeaderType)));
+    memcpy(hdr->SourceNetworkNumber, &from->sin_addr, 4);
+    memcpy(hdr->SourceNetworkNode, &from->sin_addr, 4);
+    hdr->SourceNetworkNode[4] = (unsigned char)(port >> 8);
+    hdr->SourceNetworkNode[5] = (unsigned char)(port & 0xff);
+    hdr->SourceNetworkSocket = port;
+}
+
+/*
+ * Queues a packet for the given IPX address. A node of all ones is a
+ * broadcast; a node without a port goes to the given socket.
+ */
+static int queue_packet(const void *buf, int len,
+                        const unsigned char *net,
+                        const unsigned char *node,
+                        unsigned short socket)
+{
+    static const unsigned char broadcast_node[6] = {0xff, 0xff, 0xff, 0xff, 0xff, 0xff};
+    if (memcmp(node, broadcast_node, 6) == 0) {
+        return udp_transport_broadcast(&transport, buf, len);
+    }
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    memcpy(&to.sin_addr, net, 4);
+    unsigned short port = (unsigned short)((node[4] << 8) | node[5]);
+    to.sin_port = htons(port ? port : socket);
+    return udp_transport_send(&transport, buf, len, &to);
+}
+
+int IPX_Listen_For_Packet(struct ECB *ecb_ptr)
+{
+    if (transport.socket < 0 || !ecb_ptr) {
+        return -1;
+    }
+    ecb_ptr->InUse = 1;
+    /* Anything still queued may be the packet being waited for. */
+    udp_transport_flush(&transport);
+    struct sockaddr_in from;
+    int len;
+    while ((len = udp_transport_receive(&transport, ecb_ptr->Packet[1].Address,
+                                        ecb_ptr->Packet[1].Length, &from)) < 0) {
+        if (udp_transport_wait(&transport, -1) < 0) {
+            ecb_ptr->CompletionCode = 1;
+            ecb_ptr->InUse = 0;
+            return -1;
+        }
+    }
+    fill_header((IPXHeaderType *)ecb_ptr->Packet[0].Address, len, &from);
+    ecb_ptr->CompletionCode = 0;
+    ecb_ptr->InUse = 0;
+    return 0;
+}
+
+void IPX_Send_Packet(struct ECB *ecb_ptr)
+{
+    if (transport.socket < 0 || !ecb_ptr) {
+        return;
+    }
+    ecb_ptr->InUse = 1;
+    IPXHeaderType *hdr = (IPXHeaderType *)ecb_ptr->Packet[0].Address;
+    /* The data is copied into the send pool, so the ECB is free at once. */
+    int rc = queue_packet(ecb_ptr->Packet[1].Address, ecb_ptr->Packet[1].Length,
+                          hdr->DestNetworkNumber, hdr->DestNetworkNode,
+                          hdr->DestNetworkSocket);
+    ecb_ptr->CompletionCode = rc == 0 ? 0 : 1;
+    ecb_ptr->InUse = 0;
+}
+
+void IPX_Flush_Packets(void)
+{
+    udp_transport_flush(&transport);
+}
+
+#else
+
 int IPX_Listen_For_Packet(struct ECB *ecb_ptr)
 {
     if (udp_socket == INVALID_SOCKET || !ecb_ptr) {
@@ -179,6 +309,13 @@ void IPX_Send_Packet(struct ECB *ecb_ptr)
     ecb_ptr->InUse = 0;
 }
 
+void IPX_Flush_Packets(void)
+{
+    /* Packets are sent as soon as they are handed over. */
+}
+
+#endif /* __linux__ */
+
 int IPX_Get_Local_Target(unsigned char *dest_network,
                          unsigned char *dest_node,
                          unsigned short dest_socket,
@@ -201,7 +338,7 @@ int IPX_Cancel_Event(struct ECB *ecb_ptr)
 
 void Let_IPX_Breath(void)
 {
-    /* no-op for UDP */
+    IPX_Flush_Packets();
 }
 
 /* ---- Windows 95 style helper wrappers ---------------------------------- */
@@ -221,6 +358,25 @@ static int stub_get_connection_number95(void)
     return IPX_Get_Connection_Number();
 }
 
+#ifdef __linux__
+
+static int stub_send_packet95(unsigned char *immed,
+                      unsigned char *buf,
+                      int buflen,
+                      unsigned char *net,
+                      unsigned char *node)
+{
+    (void)immed;
+    return queue_packet(buf, buflen, net, node, bound_port) == 0 ? 0 : 1;
+}
+
+static int stub_broadcast_packet95(unsigned char *buf, int buflen)
+{
+    return udp_transport_broadcast(&transport, buf, buflen) == 0 ? 0 : 1;
+}
+
+#else
+
 static int stub_send_packet95(unsigned char *immed,
                       unsigned char *buf,
                       int buflen,
@@ -248,6 +404,8 @@ static int stub_broadcast_packet95(unsigned char *buf, int buflen)
     return stub_send_packet95(NULL, buf, buflen, net, node_addr);
 }
 
+#endif /* __linux__ */
+
 static int stub_get_local_target95(unsigned char *dest_network,
                            unsigned char *dest_node,
                            unsigned short dest_socket,
@@ -257,6 +415,25 @@ static int stub_get_local_target95(unsigned char *dest_network,
                                 dest_socket, bridge_address);
 }
 
+#ifdef __linux__
+
+static int stub_get_outstanding_buffer95(unsigned char *buffer)
+{
+    if (transport.socket < 0 || !buffer)
+        return 0;
+
+    struct sockaddr_in from;
+    int len = udp_transport_receive(&transport, buffer + sizeof(IPXHeaderType),
+                                    UDP_MAX_PACKET, &from);
+    if (len <= 0)
+        return 0;
+
+    fill_header((IPXHeaderType *)buffer, len, &from);
+    return 1;
+}
+
+#else
+
 static int stub_get_outstanding_buffer95(unsigned char *buffer)
 {
     if (udp_socket == INVALID_SOCKET || !buffer)
@@ -297,6 +474,8 @@ static int stub_get_outstanding_buffer95(unsigned char *buffer)
     return 1;
 }
 
+#endif /* __linux__ */
+
 static int stub_start_listening95(void)
 {
     /* nothing required for UDP */
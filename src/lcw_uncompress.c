@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <string.h>
 
 /* Portable C implementation of the LCW_Uncompress routine. */
 unsigned long LCW_Uncompress(void *source, void *dest, unsigned long length)
@@ -23,22 +24,11 @@ unsigned long LCW_Uncompress(void *source, void *dest, unsigned long length)
         } else if (op == 0xFE) {
             unsigned int count = src[0] + ((unsigned int)src[1] << 8);
             unsigned char data = src[2];
-            uint32_t word = ((uint32_t)data << 24) | ((uint32_t)data << 16) |
-                             ((uint32_t)data << 8) | data;
             src += 3;
-            unsigned char *align = dst + 4 - ((uintptr_t)dst & 3);
-            count -= (unsigned int)(align - dst);
-            while (dst < align)
-                *dst++ = data;
-            uint32_t *wdst = (uint32_t *)dst;
-            dst += (count & ~3u);
-            while (wdst < (uint32_t *)dst) {
-                *wdst++ = word;
-                *wdst++ = word;
-            }
-            align = dst + (count & 3);
-            while (dst < align)
-                *dst++ = data;
+            /* Fill exactly count bytes; the old word loop stored 8 bytes per
+             * pass and could run up to 4 bytes past the fill. */
+            memset(dst, data, count);
+            dst += count;
         } else {
             unsigned int count;
             unsigned char *copy;
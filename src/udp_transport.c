@@ -0,0 +1,273 @@
+#ifdef __linux__
+#define _GNU_SOURCE
+#include <ra/udp_transport.h>
+#include <ra/debug_log.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+
+int udp_transport_open(udp_transport_t *t, unsigned short port)
+{
+    memset(t, 0, sizeof(*t));
+    t->socket = -1;
+    t->epoll = -1;
+
+    /*
+     * Take the first free port in the span so that more than one instance
+     * can run on this machine.
+     */
+    for (int i = 0; i < UDP_PORT_SPAN; i++) {
+        int fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            return -1;
+        }
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons((unsigned short)(port + i));
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == 0) {
+            t->socket = fd;
+            t->port = (unsigned short)(port + i);
+            break;
+        }
+        close(fd);
+    }
+    if (t->socket < 0) {
+        return -1;
+    }
+    t->base_port = port;
+
+    int on = 1;
+    setsockopt(t->socket, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+
+    t->epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (t->epoll < 0) {
+        udp_transport_close(t);
+        return -1;
+    }
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = t->socket;
+    if (epoll_ctl(t->epoll, EPOLL_CTL_ADD, t->socket, &ev) < 0) {
+        udp_transport_close(t);
+        return -1;
+    }
+
+    /*
+     * The message headers point straight into the pools and never change,
+     * apart from the lengths.
+     */
+    for (int i = 0; i < UDP_POOL_SIZE; i++) {
+        t->in_iov[i].iov_base = t->in[i].data;
+        t->in_iov[i].iov_len = UDP_MAX_PACKET;
+        t->in_msgs[i].msg_hdr.msg_iov = &t->in_iov[i];
+        t->in_msgs[i].msg_hdr.msg_iovlen = 1;
+        t->in_msgs[i].msg_hdr.msg_name = &t->in[i].address;
+
+        t->out_iov[i].iov_base = t->out[i].data;
+        t->out_msgs[i].msg_hdr.msg_iov = &t->out_iov[i];
+        t->out_msgs[i].msg_hdr.msg_iovlen = 1;
+        t->out_msgs[i].msg_hdr.msg_name = &t->out[i].address;
+        t->out_msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+    return 0;
+}
+
+void udp_transport_close(udp_transport_t *t)
+{
+    if (t->socket >= 0) {
+        udp_transport_flush(t);
+        close(t->socket);
+        t->socket = -1;
+    }
+    if (t->epoll >= 0) {
+        close(t->epoll);
+        t->epoll = -1;
+    }
+    t->in_next = t->in_count = 0;
+    t->out_count = 0;
+}
+
+/*
+ * Sleeps until a packet arrives or the timeout (in ms, -1 for none) runs out,
+ * then drains. Returns the number of packets waiting in the receive pool, or
+ * -1 on error.
+ */
+int udp_transport_wait(udp_transport_t *t, int timeout_ms)
+{
+    if (t->socket < 0) {
+        return -1;
+    }
+    if (t->in_next < t->in_count) {
+        return t->in_count - t->in_next;
+    }
+    struct epoll_event ev;
+    int n;
+    do {
+        n = epoll_wait(t->epoll, &ev, 1, timeout_ms);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        return n;
+    }
+    return udp_transport_drain(t);
+}
+
+/*
+ * Refills an empty receive pool with everything the socket has queued, up to
+ * the pool size, in one call. Returns the number of packets waiting.
+ */
+int udp_transport_drain(udp_transport_t *t)
+{
+    if (t->socket < 0) {
+        return 0;
+    }
+    if (t->in_next < t->in_count) {
+        return t->in_count - t->in_next;
+    }
+    t->in_next = t->in_count = 0;
+
+    for (int i = 0; i < UDP_POOL_SIZE; i++) {
+        t->in_msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+    int n;
+    do {
+        n = recvmmsg(t->socket, t->in_msgs, UDP_POOL_SIZE, MSG_DONTWAIT, NULL);
+    } while (n < 0 && errno == EINTR);
+    t->recv_calls++;
+    if (n <= 0) {
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        t->in[i].length = (int)t->in_msgs[i].msg_len;
+    }
+    t->in_count = n;
+    t->packets_in += n;
+    return n;
+}
+
+/*
+ * Copies the next received packet out of the pool, draining the socket if the
+ * pool is empty. Returns the packet length, or -1 if nothing is waiting.
+ */
+int udp_transport_receive(udp_transport_t *t, void *buf, int len, struct sockaddr_in *from)
+{
+    if (t->in_next >= t->in_count && udp_transport_drain(t) == 0) {
+        return -1;
+    }
+    udp_packet_t *p = &t->in[t->in_next++];
+    int n = p->length < len ? p->length : len;
+    memcpy(buf, p->data, n);
+    if (from) {
+        *from = p->address;
+    }
+    return n;
+}
+
+/*
+ * Queues a packet for the next flush. The pool is flushed first if it is
+ * full. Returns 0, or -1 if the packet can't be sent.
+ */
+int udp_transport_send(udp_transport_t *t, const void *buf, int len, const struct sockaddr_in *to)
+{
+    if (t->socket < 0 || len < 0 || len > UDP_MAX_PACKET) {
+        t->dropped++;
+        return -1;
+    }
+    if (t->out_count == UDP_POOL_SIZE) {
+        udp_transport_flush(t);
+    }
+    udp_packet_t *p = &t->out[t->out_count++];
+    memcpy(p->data, buf, len);
+    p->length = len;
+    p->address = *to;
+    return 0;
+}
+
+/*
+ * Queues a real broadcast for every instance port. The kernel loops a
+ * broadcast back to the sockets on this machine as well, so the other
+ * instances here get one copy each; if the broadcast is refused, the flush
+ * sends the copies over the loopback interface instead.
+ */
+int udp_transport_broadcast(udp_transport_t *t, const void *buf, int len)
+{
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = htonl(INADDR_BROADCAST);
+    int rc = 0;
+
+    for (int i = 0; i < UDP_PORT_SPAN; i++) {
+        to.sin_port = htons((unsigned short)(t->base_port + i));
+        rc |= udp_transport_send(t, buf, len, &to);
+    }
+    return rc;
+}
+
+/*
+ * Stands in for a broadcast the kernel refused, as it does with no network
+ * up, by sending the packet to its port on the loopback interface, unless
+ * that is this instance's own port. Returns 1 if a copy was sent.
+ */
+static int loopback_broadcast(udp_transport_t *t, const udp_packet_t *p)
+{
+    if (p->address.sin_addr.s_addr != htonl(INADDR_BROADCAST) ||
+        ntohs(p->address.sin_port) == t->port) {
+        return 0;
+    }
+    struct sockaddr_in to = p->address;
+    to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    t->send_calls++;
+    return sendto(t->socket, p->data, p->length, 0, (struct sockaddr *)&to, sizeof(to)) == p->length;
+}
+
+/*
+ * Writes every queued packet with one sendmmsg() call (more only if the
+ * kernel stops part way). A packet that the kernel refuses, such as a
+ * broadcast with no network up, is counted and skipped; a refused broadcast
+ * is sent to the other instances on this machine over loopback instead.
+ * Returns the number of packets sent.
+ */
+int udp_transport_flush(udp_transport_t *t)
+{
+    int sent = 0;
+    int next = 0;
+
+    if (t->socket < 0) {
+        t->out_count = 0;
+        return 0;
+    }
+    for (int i = 0; i < t->out_count; i++) {
+        t->out_iov[i].iov_len = t->out[i].length;
+    }
+    while (next < t->out_count) {
+        int n = sendmmsg(t->socket, &t->out_msgs[next], t->out_count - next, 0);
+        t->send_calls++;
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                /* The socket buffer is full; the retry logic will resend. */
+                t->dropped += t->out_count - next;
+                break;
+            }
+            LOG_CALL("udp_transport_flush: packet %d refused (errno %d)\n", next, errno);
+            t->dropped++;
+            sent += loopback_broadcast(t, &t->out[next]);
+            next++;
+            continue;
+        }
+        next += n;
+        sent += n;
+    }
+    t->packets_out += sent;
+    t->out_count = 0;
+    return sent;
+}
+
+#endif /* __linux__ */
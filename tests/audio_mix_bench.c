@@ -0,0 +1,168 @@
+/*
+ * tests/audio_mix_bench.c - headless benchmark for the soundio mixer
+ *
+ * Builds synthetic AUD samples (SOS ADPCM, raw 8-bit and raw 16-bit stereo
+ * at rates other than the device rate), keeps N voices playing and pulls
+ * M seconds of audio through the mixer callback without opening a device.
+ *
+ * usage: audio_mix_bench [voices] [seconds] [rate]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include "audio.h"
+#include "soundint.h"
+#include <ra/audio_decompress.h>
+#include <ra/miniaudio.h>
+
+/* ---- Null device: the bench drives the callback itself ---- */
+
+static ra_audio_callback bench_callback;
+
+int ra_audio_init(unsigned int sample_rate, unsigned int channels, ra_audio_callback cb)
+{
+    (void)sample_rate; (void)channels;
+    bench_callback = cb;
+    return 0;
+}
+
+void ra_audio_shutdown(void) { bench_callback = NULL; }
+void ra_timer_init(void) {}
+void ra_timer_uninit(void) {}
+int ra_timer_register(unsigned int rate, ra_timer_callback cb, int *handle)
+{
+    (void)rate; (void)cb; (void)handle;
+    return -1;
+}
+void ra_timer_remove(int handle) { (void)handle; }
+
+/* The game links CODE/ADPCM.CPP; the bench uses the C decoder in
+ * src/audio_decompress.c, which is the same algorithm. */
+void sosCODECInitStream(_SOS_COMPRESS_INFO *info)
+{
+    info->dwSampleIndex = 0;
+    info->dwPredicted = 0;
+}
+
+unsigned long sosCODECDecompressData(_SOS_COMPRESS_INFO *info, unsigned long bytes)
+{
+    return aud_sos_decompress(info, bytes);
+}
+
+/* ---- Synthetic samples ---- */
+
+static void put16(uint8_t *p, unsigned v) { p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; }
+static void put32(uint8_t *p, uint32_t v) { put16(p, v & 0xFFFF); put16(p + 2, v >> 16); }
+
+static uint8_t *make_header(unsigned rate, uint32_t size, uint32_t uncomp,
+                            int flags, int comp)
+{
+    uint8_t *aud = (uint8_t *)malloc(12 + size);
+    if (!aud) exit(1);
+    put16(aud, rate);
+    put32(aud + 2, size);
+    put32(aud + 6, uncomp);
+    aud[10] = (uint8_t)flags;
+    aud[11] = (uint8_t)comp;
+    return aud;
+}
+
+/* Any nibble stream is valid ADPCM, so random chunks decode to noise. */
+static uint8_t *make_sos(unsigned rate, long frames)
+{
+    long bytes = frames / 2;
+    long chunks = (bytes + 511) / 512;
+    uint8_t *aud = make_header(rate, (uint32_t)(bytes + chunks * 8),
+                               (uint32_t)(bytes * 4), AUD_FLAG_16BIT, SCOMP_SOS);
+    uint8_t *p = aud + 12;
+    for (long left = bytes; left > 0; left -= 512) {
+        unsigned n = left > 512 ? 512 : (unsigned)left;
+        put16(p, n);
+        put16(p + 2, n * 4);
+        put32(p + 4, 0x0000DEAF);
+        p += 8;
+        for (unsigned i = 0; i < n; ++i) *p++ = (uint8_t)rand();
+    }
+    return aud;
+}
+
+static uint8_t *make_raw8(unsigned rate, long frames)
+{
+    uint8_t *aud = make_header(rate, (uint32_t)frames, (uint32_t)frames, 0, SCOMP_NONE);
+    for (long i = 0; i < frames; ++i)
+        aud[12 + i] = (uint8_t)(128 + ((i * 7) & 63) - 32);
+    return aud;
+}
+
+static uint8_t *make_raw16_stereo(unsigned rate, long frames)
+{
+    uint32_t size = (uint32_t)(frames * 4);
+    uint8_t *aud = make_header(rate, size, size, AUD_FLAG_16BIT | AUD_FLAG_STEREO, SCOMP_NONE);
+    for (long i = 0; i < frames * 2; ++i)
+        put16(aud + 12 + i * 2, (unsigned)(int16_t)((i * 97) % 16384 - 8192));
+    return aud;
+}
+
+int main(int argc, char **argv)
+{
+    int voices = argc > 1 ? atoi(argv[1]) : 16;
+    int seconds = argc > 2 ? atoi(argv[2]) : 10;
+    int rate = argc > 3 ? atoi(argv[3]) : 44100;
+    if (voices < 1) voices = 1;
+    if (voices > SOUNDIO_VOICES) voices = SOUNDIO_VOICES;
+
+    uint8_t *samples[3] = {
+        make_sos(22050, 22050),
+        make_raw8(11025, 11025 / 2),
+        make_raw16_stereo(22050, 22050 / 3),
+    };
+
+    if (!Audio_Init(NULL, 16, TRUE, rate, 0) || !bench_callback) {
+        fprintf(stderr, "audio_mix_bench: Audio_Init failed\n");
+        return 1;
+    }
+
+    enum { BLOCK = 1024 };
+    static int16_t out[BLOCK * 2];
+    long total = (long)seconds * rate;
+    long peak = 0;
+    int handles[SOUNDIO_VOICES];
+
+    for (int v = 0; v < voices; ++v) {
+        signed short pan = (signed short)(-32767 + (65534L * v) / (voices > 1 ? voices - 1 : 1));
+        handles[v] = Play_Sample_Handle(samples[v % 3], 255, 200, pan, v);
+        if (handles[v] < 0) {
+            fprintf(stderr, "audio_mix_bench: voice %d failed to start\n", v);
+            return 1;
+        }
+    }
+
+    clock_t start = clock();
+    for (long done = 0; done < total; done += BLOCK) {
+        for (int v = 0; v < voices; ++v) {
+            if (!Sample_Status(handles[v])) {
+                signed short pan = (signed short)((v & 1) ? 16384 : -16384);
+                Play_Sample_Handle(samples[v % 3], 255, 200, pan, v);
+            }
+        }
+        bench_callback(out, BLOCK);
+        for (int i = 0; i < BLOCK * 2; ++i) {
+            long a = labs((long)out[i]);
+            if (a > peak) peak = a;
+        }
+    }
+    double cpu = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("voices=%d seconds=%d rate=%d\n", voices, seconds, rate);
+    printf("cpu=%.3fs (%.2f%% of real time, %.1fx faster) peak=%ld\n",
+           cpu, 100.0 * cpu / seconds, cpu > 0 ? seconds / cpu : 0.0, peak);
+
+    Sound_End();
+    for (int i = 0; i < 3; ++i) free(samples[i]);
+
+    /* Silence means the voices never reached the mix. */
+    return peak > 0 ? 0 : 1;
+}
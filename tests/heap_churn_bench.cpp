@@ -0,0 +1,303 @@
+/*
+ * tests/heap_churn_bench.cpp - headless benchmark for the game object heaps
+ *
+ * Churns two TFixedIHeapClass heaps holding objects the size of bullets and
+ * animations the way a big fight does: every frame the active list is walked
+ * in order, a share of the objects delete themselves during the walk (the
+ * walk steps back one slot, as the logic loops do), the survivors are looked
+ * up by Logical_ID, and new objects are allocated to replace the dead. The
+ * same workload is run against a copy of the original heap (a linear scan
+ * for the lowest free slot, a linear search for the pointer to remove and
+ * a linear Logical_ID) and the two must hand out the same slots and keep the
+ * same iteration order on every frame.
+ *
+ * The real CODE/HEAP.CPP, VECTOR.CPP and DYNAVEC.CPP are compiled in. Their
+ * function.h and jshell.h are kept out with the include guards and the few
+ * things the heap needs from them are supplied here.
+ *
+ * usage: heap_churn_bench [frames] [bullets] [anims]
+ */
+
+#define FUNCTION_H
+#define JSHELL_H
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+class NoInitClass {
+	public:
+		void operator () (void) const {};
+};
+
+static inline void Set_Bit(void *array, int bit, int value)
+{
+    unsigned char *p = (unsigned char *)array + (bit >> 3);
+    if (value) *p |= (unsigned char)(1 << (bit & 7));
+    else       *p &= (unsigned char)~(1 << (bit & 7));
+}
+
+static inline int Get_Bit(const void *array, int bit)
+{
+    return (((const unsigned char *)array)[bit >> 3] >> (bit & 7)) & 1;
+}
+
+static inline int First_True_Bit(const void *array)
+{
+    const uint32_t *d = (const uint32_t *)array;
+    int offset = 0;
+    while (*d == 0u) { ++d; offset += 32; }
+    return offset + __builtin_ctz(*d);
+}
+
+static inline int First_False_Bit(const void *array)
+{
+    const uint32_t *d = (const uint32_t *)array;
+    int offset = 0;
+    while (*d == 0xFFFFFFFFu) { ++d; offset += 32; }
+    return offset + __builtin_ctz(~*d);
+}
+
+#include "pipe.h"
+#include "straw.h"
+#include "vector.h"
+#include "VECTOR.CPP"
+#include "DYNAVEC.CPP"
+#include "heap.h"
+#include "HEAP.CPP"
+
+/* Roughly sizeof(BulletClass) and sizeof(AnimClass) in a 32-bit build. */
+struct BulletSized {
+    BulletSized(NoInitClass const &) {}
+    void Code_Pointers(void) {}
+    void Decode_Pointers(void) {}
+    unsigned char Data[176];
+};
+
+struct AnimSized {
+    AnimSized(NoInitClass const &) {}
+    void Code_Pointers(void) {}
+    void Decode_Pointers(void) {}
+    unsigned char Data[112];
+};
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static uint32_t rng_state;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ---- Reference heap: the original FixedIHeapClass algorithm ---- */
+
+class RefHeap {
+    public:
+        RefHeap(int size, int count) : Size(size), Total(count), Active(0) {
+            Buffer = new char[size * count];
+            Used = new bool[count];
+            Pointers = new void *[count];
+            memset(Used, 0, count);
+        }
+        ~RefHeap() { delete[] Buffer; delete[] Used; delete[] Pointers; }
+
+        int Count(void) const { return Active; }
+        int ID(void const *p) const { return (int)(((char const *)p - Buffer) / Size); }
+        void *Ptr(int index) const { return Pointers[index]; }
+
+        void *Alloc(void) {
+            for (int i = 0; i < Total; i++) {
+                if (!Used[i]) {
+                    Used[i] = true;
+                    void *p = Buffer + i * Size;
+                    Pointers[Active++] = p;
+                    memset(p, 0, Size);
+                    return p;
+                }
+            }
+            return NULL;
+        }
+
+        void Free(void *p) {
+            Used[ID(p)] = false;
+            for (int i = 0; i < Active; i++) {
+                if (Pointers[i] == p) {
+                    for (--Active; i < Active; i++) Pointers[i] = Pointers[i+1];
+                    return;
+                }
+            }
+        }
+
+        int Logical_ID(void const *p) const {
+            for (int i = 0; i < Active; i++) {
+                if (Pointers[i] == p) return i;
+            }
+            return -1;
+        }
+
+    private:
+        int Size;
+        int Total;
+        int Active;
+        char *Buffer;
+        bool *Used;
+        void **Pointers;
+};
+
+/* ---- Workload ---- */
+
+/*
+ * One frame of churn. Returns a checksum of the slot IDs and logical IDs seen
+ * so that the reference and the real heap can be compared.
+ */
+template<class H, class T>
+static uint32_t churn(H &heap, int capacity, uint32_t sum)
+{
+    /* Walk the active list. Some objects die during the walk. */
+    for (int i = 0; i < heap.Count(); i++) {
+        T *obj = (T *)heap.Ptr(i);
+        obj->Data[0]++;
+        if (rng() % 100 < 30) {
+            heap.Free(obj);
+            i--;
+            continue;
+        }
+        sum = sum * 31 + heap.ID(obj);
+    }
+
+    /* Look up some of the survivors, as target and trigger code does. */
+    for (int n = 0; n < 8 && heap.Count() > 0; n++) {
+        T *obj = (T *)heap.Ptr(rng() % heap.Count());
+        sum = sum * 31 + heap.Logical_ID(obj);
+    }
+
+    /* Spawn new objects, up to a random fill level. */
+    int want = capacity / 2 + rng() % (capacity / 2 + 1);
+    while (heap.Count() < want) {
+        T *obj = (T *)heap.Alloc();
+        if (obj == NULL) break;
+        sum = sum * 31 + heap.ID(obj);
+    }
+    return sum;
+}
+
+struct Result {
+    double ms;
+    uint32_t sum;
+};
+
+template<class B, class A>
+static Result run(B &bullets, A &anims, int frames, int nbullets, int nanims)
+{
+    Result r;
+    rng_state = 0x12345678;
+    r.sum = 0;
+    double t0 = now_ms();
+    for (int f = 0; f < frames; f++) {
+        r.sum = churn<B, BulletSized>(bullets, nbullets, r.sum);
+        r.sum = churn<A, AnimSized>(anims, nanims, r.sum);
+    }
+    r.ms = now_ms() - t0;
+    return r;
+}
+
+/*
+ * Runs both heaps side by side and checks the slot and order of every active
+ * object after every frame.
+ */
+static int check(int frames, int count)
+{
+    RefHeap ref(sizeof(AnimSized), count);
+    TFixedIHeapClass<AnimSized> heap;
+    heap.Set_Heap(count);
+
+    uint32_t state = 0x9E3779B9;
+    for (int f = 0; f < frames; f++) {
+        rng_state = state;
+        churn<RefHeap, AnimSized>(ref, count, 0);
+        rng_state = state;
+        churn<TFixedIHeapClass<AnimSized>, AnimSized>(heap, count, 0);
+        state = rng();
+
+        if (ref.Count() != heap.Count()) {
+            fprintf(stderr, "frame %d: %d objects, reference has %d\n", f, heap.Count(), ref.Count());
+            return 1;
+        }
+        for (int i = 0; i < heap.Count(); i++) {
+            if (ref.ID(ref.Ptr(i)) != heap.ID(heap.Ptr(i))) {
+                fprintf(stderr, "frame %d: object %d is slot %d, reference has slot %d\n",
+                        f, i, heap.ID(heap.Ptr(i)), ref.ID(ref.Ptr(i)));
+                return 1;
+            }
+            if (heap.Logical_ID(heap.Ptr(i)) != i) {
+                fprintf(stderr, "frame %d: Logical_ID of object %d is %d\n", f, i, heap.Logical_ID(heap.Ptr(i)));
+                return 1;
+            }
+        }
+
+        /* Every so often, empty the heap the way a scenario restart does. */
+        if (f % 197 == 196) {
+            heap.Free_All();
+            while (ref.Count() > 0) ref.Free(ref.Ptr(0));
+        }
+    }
+    if (heap.Logical_ID((AnimSized const *)NULL) != -1) {
+        fprintf(stderr, "Logical_ID of NULL is not -1\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 20000;
+    int nbullets = argc > 2 ? atoi(argv[2]) : 40;
+    int nanims = argc > 3 ? atoi(argv[3]) : 100;
+
+    if (frames <= 0 || nbullets <= 0 || nanims <= 0) {
+        fprintf(stderr, "usage: %s [frames] [bullets] [anims]\n", argv[0]);
+        return 1;
+    }
+
+    /*
+     * Odd sizes exercise the spare bits at the end of the allocation words. A
+     * short run checks fewer frames, so that it stays quick.
+     */
+    static int const sizes[] = {1, 31, 32, 33, 100, 1023, 1024, 1025, 2500};
+    int checks = frames < 600 ? frames : 600;
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        if (check(checks, sizes[s])) return 1;
+    }
+
+    RefHeap refbullets(sizeof(BulletSized), nbullets);
+    RefHeap refanims(sizeof(AnimSized), nanims);
+    Result ref = run(refbullets, refanims, frames, nbullets, nanims);
+
+    TFixedIHeapClass<BulletSized> bullets;
+    TFixedIHeapClass<AnimSized> anims;
+    bullets.Set_Heap(nbullets);
+    anims.Set_Heap(nanims);
+    Result real = run(bullets, anims, frames, nbullets, nanims);
+
+    printf("%d frames, %d bullets, %d anims\n", frames, nbullets, nanims);
+    printf("reference heap: %9.2f ms  %7.3f us/frame\n", ref.ms, ref.ms * 1000.0 / frames);
+    printf("heap:           %9.2f ms  %7.3f us/frame\n", real.ms, real.ms * 1000.0 / frames);
+
+    if (ref.sum != real.sum) {
+        fprintf(stderr, "slot checksums differ: ref %08x heap %08x\n", ref.sum, real.sum);
+        return 1;
+    }
+    return 0;
+}
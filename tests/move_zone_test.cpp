@@ -0,0 +1,340 @@
+/*
+ * tests/move_zone_test.cpp - zone number test for the incremental zone tracker
+ *
+ * Builds a random map of open ground, rock, water and walls, floods the
+ * movement zones with a full zone reset, then changes a few cells at a time
+ * the way walls being built, bridges being blown and trees being cut do.
+ * Every changed cell is touched and the zones are brought up to date with
+ * MoveZoneClass::Update, the way MapClass::Zone_Update does it. After every
+ * update the zone number of every cell must be exactly what a full flood fill
+ * of the changed map gives, for every zone type that was updated.
+ *
+ * The real CODE/MZONE.CPP is compiled in with VERIFY_CACHES on, so a rebuild
+ * also cross checks its regions against the flood fill. Its function.h is kept
+ * out with the include guard; the cell helpers and a stand-in for the map are
+ * supplied here. The flood fill is a copy of MapClass::Zone_Reset and
+ * MapClass::Zone_Span.
+ *
+ * usage: move_zone_test [seeds] [changes]
+ */
+
+#define FUNCTION_H
+#define JSHELL_H
+#define VERIFY_CACHES
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * glibc's <endian.h> defines BIG_ENDIAN as a byte order constant on every
+ * machine, which would flip the cell bit fields in defines.h.
+ */
+#undef BIG_ENDIAN
+
+template<class T> inline T operator ++(T & a, int)
+{
+    T aa = a;
+    a = (T)((int)a + (int)1);
+    return(aa);
+}
+
+#include "fixed.h"
+#include "defines.h"
+
+inline CELL XY_Cell(int x, int y)
+{
+    CELL_COMPOSITE cell;
+    cell.Cell = 0;
+    cell.Sub.X = x;
+    cell.Sub.Y = y;
+    return(cell.Cell);
+}
+
+inline int Cell_X(CELL cell)
+{
+    CELL_COMPOSITE composite = {0};
+    composite.Cell = cell;
+    return(composite.Sub.X);
+}
+
+inline int Cell_Y(CELL cell)
+{
+    CELL_COMPOSITE composite = {0};
+    composite.Cell = cell;
+    return(composite.Sub.Y);
+}
+
+/* ---- Stand-in for the map ---- */
+
+enum { GROUND, ROCK, WATER, WALL };
+
+struct CellStandIn {
+    unsigned char Land;
+    unsigned char Zones[MZONE_COUNT];
+
+    /* Walls only stop units that can't destroy them. */
+    bool Is_Clear_To_Move(SpeedType, bool, bool, int, MZoneType check) const
+    {
+        switch (Land) {
+        case GROUND: return check != MZONE_WATER;
+        case WALL:   return check == MZONE_DESTROYER;
+        case WATER:  return check == MZONE_WATER;
+        default:     return false;
+        }
+    }
+};
+
+struct MapStandIn {
+    int MapCellX;
+    int MapCellY;
+    int MapCellWidth;
+    int MapCellHeight;
+    CellStandIn Cells[MAP_CELL_TOTAL];
+
+    /* Full zone resets, whether asked for by the test or by the tracker. */
+    long Resets;
+
+    CellStandIn & operator [] (CELL cell) { return Cells[cell]; }
+
+    void Zone_Flood(int method);
+    int Zone_Span(CELL cell, int zone, MZoneType check);
+    bool Zone_Reset(int method);
+};
+
+static MapStandIn Map;
+
+#include "mzone.h"
+#include "MZONE.CPP"
+
+static MoveZoneClass MoveZones;
+
+/*
+ * The zone recalculation of MapClass::Zone_Reset.
+ */
+void MapStandIn::Zone_Flood(int method)
+{
+    for (int index = 0; index < MAP_CELL_TOTAL; index++) {
+        for (int zone = MZONE_FIRST; zone < MZONE_COUNT; zone++) {
+            if (method & (1 << zone)) Cells[index].Zones[zone] = 0;
+        }
+    }
+    for (int zone = MZONE_FIRST; zone < MZONE_COUNT; zone++) {
+        if (!(method & (1 << zone))) continue;
+
+        int number = 1;
+        for (CELL cell = 0; cell < MAP_CELL_TOTAL; cell++) {
+            if (Zone_Span(cell, number, (MZoneType)zone)) {
+                number++;
+            }
+        }
+    }
+}
+
+/*
+ * MapClass::Zone_Span as it stands, apart from the scope of the last loop
+ * variable.
+ */
+int MapStandIn::Zone_Span(CELL cell, int zone, MZoneType check)
+{
+    int filled = 0;
+    int xbegin = Cell_X(cell);
+    int xend = xbegin;
+    int y = Cell_Y(cell);
+
+    if (y < MapCellY || y >= MapCellY+MapCellHeight || xbegin < MapCellX || xbegin >= MapCellX+MapCellWidth) {
+        return(0);
+    }
+
+    for (; xbegin >= MapCellX; xbegin--) {
+        CellStandIn * cellptr = &(*this)[XY_Cell(xbegin, y)];
+        if (cellptr->Zones[check] != 0 || (!cellptr->Is_Clear_To_Move(check == MZONE_WATER ? SPEED_FLOAT : SPEED_TRACK, true, true, -1, check))) {
+            if (xbegin == Cell_X(cell)) return(0);
+            xbegin++;
+            break;
+        }
+    }
+    if (xbegin < MapCellX) xbegin = MapCellX;
+
+    for (; xend < MapCellX+MapCellWidth; xend++) {
+        CellStandIn * cellptr = &(*this)[XY_Cell(xend, y)];
+        if (cellptr->Zones[check] != 0 || (!cellptr->Is_Clear_To_Move(check == MZONE_WATER ? SPEED_FLOAT : SPEED_TRACK, true, true, -1, check))) {
+            xend--;
+            break;
+        }
+    }
+    if (xend > MapCellX+MapCellWidth-1) xend = MapCellX+MapCellWidth-1;
+
+    for (int x = xbegin; x <= xend; x++) {
+        (*this)[XY_Cell(x, y)].Zones[check] = zone;
+        filled++;
+    }
+
+    for (int x = xbegin-1; x <= xend; x++) {
+        filled += Zone_Span(XY_Cell(x, y-1), zone, check);
+        filled += Zone_Span(XY_Cell(x, y+1), zone, check);
+    }
+    return(filled);
+}
+
+bool MapStandIn::Zone_Reset(int method)
+{
+    Resets++;
+    Zone_Flood(method);
+    MoveZones.Rebuild(method);
+    return(false);
+}
+
+static unsigned long Seed;
+
+static int Random(int range)
+{
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (int)((Seed >> 16) & 0x7FFF) % range;
+}
+
+/* ---- Map generation and changes ---- */
+
+static void Paint(int x, int y, int radius, unsigned char land)
+{
+    for (int cy = y - radius; cy <= y + radius; cy++) {
+        for (int cx = x - radius; cx <= x + radius; cx++) {
+            if (cx < 0 || cx >= MAP_CELL_W || cy < 0 || cy >= MAP_CELL_H) continue;
+            if ((cx - x) * (cx - x) + (cy - y) * (cy - y) > radius * radius) continue;
+            Map[XY_Cell(cx, cy)].Land = land;
+        }
+    }
+}
+
+static void Make_Map(void)
+{
+    Map.MapCellX = 1 + Random(8);
+    Map.MapCellY = 1 + Random(8);
+    Map.MapCellWidth = MAP_CELL_W - Map.MapCellX - 1 - Random(8);
+    Map.MapCellHeight = MAP_CELL_H - Map.MapCellY - 1 - Random(8);
+
+    for (int cell = 0; cell < MAP_CELL_TOTAL; cell++) {
+        Map.Cells[cell].Land = GROUND;
+    }
+    for (int i = 0; i < 12; i++) {
+        Paint(Random(MAP_CELL_W), Random(MAP_CELL_H), 3 + Random(10), WATER);
+    }
+    for (int i = 0; i < 60; i++) {
+        Paint(Random(MAP_CELL_W), Random(MAP_CELL_H), 1 + Random(4), ROCK);
+    }
+
+    /* Long walls with the odd gap, so that zones are split and joined. */
+    for (int i = 0; i < 16; i++) {
+        int x = Random(MAP_CELL_W);
+        int y = Random(MAP_CELL_H);
+        bool across = Random(2) != 0;
+        int length = 10 + Random(60);
+        for (int n = 0; n < length; n++) {
+            int cx = across ? x + n : x;
+            int cy = across ? y : y + n;
+            if (cx >= MAP_CELL_W || cy >= MAP_CELL_H) break;
+            if (Random(20) != 0) Map[XY_Cell(cx, cy)].Land = WALL;
+        }
+    }
+}
+
+/*
+ * Changes a handful of cells near each other, touching each one the way the
+ * game does after it changes a cell. Returns the number of cells changed.
+ */
+static int Change_Cells(void)
+{
+    static const unsigned char lands[] = {GROUND, ROCK, WATER, WALL};
+    int x = Random(MAP_CELL_W);
+    int y = Random(MAP_CELL_H);
+    int count = 1 + Random(6);
+
+    for (int i = 0; i < count; i++) {
+        int cx = x + Random(5) - 2;
+        int cy = y + Random(5) - 2;
+        if (cx < 0 || cx >= MAP_CELL_W || cy < 0 || cy >= MAP_CELL_H) continue;
+
+        CELL cell = XY_Cell(cx, cy);
+        Map[cell].Land = lands[Random(4)];
+        MoveZones.Touch(cell);
+    }
+    return count;
+}
+
+static unsigned char Updated[MAP_CELL_TOTAL][MZONE_COUNT];
+
+/*
+ * Compares the zone numbers left by the update with a full flood fill of the
+ * same map. Returns zero if they match.
+ */
+static int Check_Zones(int method)
+{
+    for (int cell = 0; cell < MAP_CELL_TOTAL; cell++) {
+        memcpy(Updated[cell], Map.Cells[cell].Zones, MZONE_COUNT);
+    }
+    Map.Zone_Flood(method);
+
+    for (int zone = MZONE_FIRST; zone < MZONE_COUNT; zone++) {
+        if (!(method & (1 << zone))) continue;
+
+        for (CELL cell = 0; cell < MAP_CELL_TOTAL; cell++) {
+            if (Updated[cell][zone] != Map[cell].Zones[zone]) {
+                fprintf(stderr, "zone type %d, cell %d,%d: zone %d after the update, %d after a reset\n",
+                        zone, Cell_X(cell), Cell_Y(cell), Updated[cell][zone], Map[cell].Zones[zone]);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int seeds = argc > 1 ? atoi(argv[1]) : 20;
+    int changes = argc > 2 ? atoi(argv[2]) : 200;
+
+    if (seeds <= 0 || changes <= 0) {
+        fprintf(stderr, "usage: %s [seeds] [changes]\n", argv[0]);
+        return 1;
+    }
+
+    long cells = 0;
+    long updates = 0;
+    long fallbacks = 0;
+    for (int s = 1; s <= seeds; s++) {
+        Seed = (unsigned long)s;
+        Make_Map();
+        Map.Zone_Reset(MZONEF_ALL);
+
+        for (int c = 1; c <= changes; c++) {
+            cells += Change_Cells();
+
+            /*
+             * Most updates cover every zone type, the rest only some of them, and
+             * the last one catches up on all of them.
+             */
+            int method = MZONEF_ALL;
+            if (c < changes && Random(4) == 0) method = 1 + Random(MZONEF_ALL);
+
+            long resets = Map.Resets;
+            MoveZones.Update(method);
+            updates++;
+            if (Map.Resets != resets) fallbacks++;
+
+            if (Check_Zones(method)) {
+                fprintf(stderr, "seed %d, change %d\n", s, c);
+                return 1;
+            }
+        }
+    }
+
+    printf("%d maps, %ld cells changed, %ld updates\n", seeds, cells, updates);
+    printf("%ld updates fell back to a full zone reset\n", fallbacks);
+
+    if (fallbacks == updates) {
+        fprintf(stderr, "no update was incremental\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,408 @@
+/*
+ * tests/path_graph_test.cpp - route test for the cluster level path graph
+ *
+ * Builds a random map of open ground, rock, water and walls, then changes a
+ * few cells at a time the way walls being built, bridges being blown and
+ * trees being cut do. After every change one graph is told about the changed
+ * cells (PathGraphClass::Touch, as MapClass::Zone_Update does) and rebuilds
+ * only their clusters, while a second graph is thrown away and rebuilt from
+ * scratch. For random trips in every movement zone type:
+ *
+ *   - both graphs must pick the same waypoint;
+ *   - a waypoint may only be picked when a flat cell level A* search can get
+ *     from the start to the destination, and it must lie on the way there;
+ *   - following the waypoints one after another must reach the destination,
+ *     and on average must not cost much more than the flat A* path.
+ *
+ * The real CODE/PATHGRPH.CPP is compiled in. Its function.h is kept out with
+ * the include guard; the cell helpers and a stand-in for the map are supplied
+ * here.
+ *
+ * usage: path_graph_test [seeds] [changes]
+ */
+
+#define FUNCTION_H
+#define JSHELL_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * glibc's <endian.h> defines BIG_ENDIAN as a byte order constant on every
+ * machine, which would flip the cell bit fields in defines.h.
+ */
+#undef BIG_ENDIAN
+
+template<class T> inline T operator ++(T & a, int)
+{
+    T aa = a;
+    a = (T)((int)a + (int)1);
+    return(aa);
+}
+
+template<class T> T ABS(T a)
+{
+    return (a < 0) ? -a : a;
+}
+
+#include "fixed.h"
+#include "defines.h"
+
+inline CELL XY_Cell(int x, int y)
+{
+    CELL_COMPOSITE cell;
+    cell.Cell = 0;
+    cell.Sub.X = x;
+    cell.Sub.Y = y;
+    return(cell.Cell);
+}
+
+inline int Cell_X(CELL cell)
+{
+    CELL_COMPOSITE composite = {0};
+    composite.Cell = cell;
+    return(composite.Sub.X);
+}
+
+inline int Cell_Y(CELL cell)
+{
+    CELL_COMPOSITE composite = {0};
+    composite.Cell = cell;
+    return(composite.Sub.Y);
+}
+
+/* ---- Stand-in for the map ---- */
+
+enum { GROUND, ROCK, WATER, WALL };
+
+struct CellStandIn {
+    unsigned char Land;
+
+    /* Walls only stop units that can't destroy them. */
+    bool Is_Clear_To_Move(SpeedType, bool, bool, int, MZoneType check) const
+    {
+        switch (Land) {
+        case GROUND: return check != MZONE_WATER;
+        case WALL:   return check == MZONE_DESTROYER;
+        case WATER:  return check == MZONE_WATER;
+        default:     return false;
+        }
+    }
+};
+
+struct MapStandIn {
+    int MapCellX;
+    int MapCellY;
+    int MapCellWidth;
+    int MapCellHeight;
+    CellStandIn Cells[MAP_CELL_TOTAL];
+
+    CellStandIn & operator [] (CELL cell) { return Cells[cell]; }
+};
+
+static MapStandIn Map;
+
+#include "pathgrph.h"
+#include "PATHGRPH.CPP"
+
+static PathGraphClass Incremental;
+static PathGraphClass Fresh;
+
+static unsigned long Seed;
+
+static int Random(int range)
+{
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (int)((Seed >> 16) & 0x7FFF) % range;
+}
+
+static bool Passable(CELL cell, MZoneType check)
+{
+    int x = Cell_X(cell);
+    int y = Cell_Y(cell);
+    if (x < Map.MapCellX || x >= Map.MapCellX + Map.MapCellWidth ||
+        y < Map.MapCellY || y >= Map.MapCellY + Map.MapCellHeight) {
+        return false;
+    }
+    return Map[cell].Is_Clear_To_Move(SPEED_TRACK, true, true, -1, check);
+}
+
+/* ---- Flat A* over the cells, costs in the graph's half cell units ---- */
+
+static int Distance(CELL a, CELL b)
+{
+    int dx = ABS(Cell_X(a) - Cell_X(b));
+    int dy = ABS(Cell_Y(a) - Cell_Y(b));
+    return dx > dy ? dx * 2 + dy : dy * 2 + dx;
+}
+
+static int FlatCost[MAP_CELL_TOTAL];
+static unsigned FlatStamp[MAP_CELL_TOTAL];
+static unsigned FlatSearch;
+static long FlatOpen[MAP_CELL_TOTAL * 8];
+
+/*
+ * Returns the cost of the cheapest 8-way path between the cells, or -1 if
+ * there is none.
+ */
+static int Flat_Path(CELL from, CELL to, MZoneType check)
+{
+    if (!Passable(from, check) || !Passable(to, check)) return -1;
+
+    FlatSearch++;
+    int count = 0;
+    FlatStamp[from] = FlatSearch;
+    FlatCost[from] = 0;
+    FlatOpen[count++] = ((long)Distance(from, to) << 16) | (unsigned short)from;
+
+    while (count > 0) {
+        long top = FlatOpen[0];
+        FlatOpen[0] = FlatOpen[--count];
+        for (int pos = 0;;) {
+            int child = pos * 2 + 1;
+            if (child >= count) break;
+            if (child + 1 < count && FlatOpen[child + 1] < FlatOpen[child]) child++;
+            if (FlatOpen[pos] <= FlatOpen[child]) break;
+            long temp = FlatOpen[pos];
+            FlatOpen[pos] = FlatOpen[child];
+            FlatOpen[child] = temp;
+            pos = child;
+        }
+
+        CELL cell = (CELL)(top & 0xFFFF);
+        if (cell == to) return FlatCost[cell];
+        if ((int)(top >> 16) > FlatCost[cell] + Distance(cell, to)) continue;
+
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = Cell_X(cell) + dx;
+                int ny = Cell_Y(cell) + dy;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= MAP_CELL_W || ny < 0 || ny >= MAP_CELL_H) continue;
+
+                CELL next = XY_Cell(nx, ny);
+                if (!Passable(next, check)) continue;
+
+                int cost = FlatCost[cell] + ((dx != 0 && dy != 0) ? 3 : 2);
+                if (FlatStamp[next] == FlatSearch && FlatCost[next] <= cost) continue;
+                FlatStamp[next] = FlatSearch;
+                FlatCost[next] = cost;
+
+                int pos = count++;
+                FlatOpen[pos] = ((long)(cost + Distance(next, to)) << 16) | (unsigned short)next;
+                while (pos > 0) {
+                    int parent = (pos - 1) / 2;
+                    if (FlatOpen[parent] <= FlatOpen[pos]) break;
+                    long temp = FlatOpen[pos];
+                    FlatOpen[pos] = FlatOpen[parent];
+                    FlatOpen[parent] = temp;
+                    pos = parent;
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+/* ---- Map generation and changes ---- */
+
+static void Paint(int x, int y, int radius, unsigned char land)
+{
+    for (int cy = y - radius; cy <= y + radius; cy++) {
+        for (int cx = x - radius; cx <= x + radius; cx++) {
+            if (cx < 0 || cx >= MAP_CELL_W || cy < 0 || cy >= MAP_CELL_H) continue;
+            if ((cx - x) * (cx - x) + (cy - y) * (cy - y) > radius * radius) continue;
+            Map[XY_Cell(cx, cy)].Land = land;
+        }
+    }
+}
+
+static void Make_Map(void)
+{
+    Map.MapCellX = 1 + Random(8);
+    Map.MapCellY = 1 + Random(8);
+    Map.MapCellWidth = MAP_CELL_W - Map.MapCellX - 1 - Random(8);
+    Map.MapCellHeight = MAP_CELL_H - Map.MapCellY - 1 - Random(8);
+
+    for (int cell = 0; cell < MAP_CELL_TOTAL; cell++) {
+        Map.Cells[cell].Land = GROUND;
+    }
+    for (int i = 0; i < 12; i++) {
+        Paint(Random(MAP_CELL_W), Random(MAP_CELL_H), 3 + Random(10), WATER);
+    }
+    for (int i = 0; i < 60; i++) {
+        Paint(Random(MAP_CELL_W), Random(MAP_CELL_H), 1 + Random(4), ROCK);
+    }
+
+    /* Long walls with the odd gap, so that the routes have to go around. */
+    for (int i = 0; i < 16; i++) {
+        int x = Random(MAP_CELL_W);
+        int y = Random(MAP_CELL_H);
+        bool across = Random(2) != 0;
+        int length = 10 + Random(60);
+        for (int n = 0; n < length; n++) {
+            int cx = across ? x + n : x;
+            int cy = across ? y : y + n;
+            if (cx >= MAP_CELL_W || cy >= MAP_CELL_H) break;
+            if (Random(20) != 0) Map[XY_Cell(cx, cy)].Land = WALL;
+        }
+    }
+}
+
+/*
+ * Changes a handful of cells near each other, touching each one the way the
+ * game does after it changes a cell. Returns the number of cells changed.
+ */
+static int Change_Cells(void)
+{
+    static const unsigned char lands[] = {GROUND, ROCK, WATER, WALL};
+    int x = Random(MAP_CELL_W);
+    int y = Random(MAP_CELL_H);
+    int count = 1 + Random(6);
+
+    for (int i = 0; i < count; i++) {
+        int cx = x + Random(5) - 2;
+        int cy = y + Random(5) - 2;
+        if (cx < 0 || cx >= MAP_CELL_W || cy < 0 || cy >= MAP_CELL_H) continue;
+
+        CELL cell = XY_Cell(cx, cy);
+        Map[cell].Land = lands[Random(4)];
+        Incremental.Touch(cell, MZONEF_ALL);
+    }
+    Fresh.Invalidate(MZONEF_ALL);
+    return count;
+}
+
+static CELL Random_Cell(MZoneType check)
+{
+    for (int tries = 0; tries < 1000; tries++) {
+        CELL cell = XY_Cell(Random(MAP_CELL_W), Random(MAP_CELL_H));
+        if (Passable(cell, check)) return cell;
+    }
+    return XY_Cell(0, 0);
+}
+
+/*
+ * How much more the trips that follow the waypoints may cost on average than
+ * the flat A* paths.
+ */
+#define MEAN_STRETCH    1.15
+
+static long Trips;
+static long Routed;
+static long Unreachable;
+static double WorstStretch;
+static double TotalStretch;
+
+/*
+ * Checks one trip. Returns zero if the graphs behaved.
+ */
+static int Check_Trip(CELL source, CELL dest, MZoneType check)
+{
+    CELL waypoint = Incremental.Waypoint(source, dest, check);
+    CELL fresh = Fresh.Waypoint(source, dest, check);
+    if (waypoint != fresh) {
+        fprintf(stderr, "zone %d, %d,%d to %d,%d: waypoint %d,%d after touching, %d,%d after a rebuild\n",
+                check, Cell_X(source), Cell_Y(source), Cell_X(dest), Cell_Y(dest),
+                Cell_X(waypoint), Cell_Y(waypoint), Cell_X(fresh), Cell_Y(fresh));
+        return 1;
+    }
+
+    Trips++;
+    int best = Flat_Path(source, dest, check);
+    if (best < 0) {
+        Unreachable++;
+        if (waypoint != dest) {
+            fprintf(stderr, "zone %d, %d,%d to %d,%d: waypoint %d,%d but there is no path\n",
+                    check, Cell_X(source), Cell_Y(source), Cell_X(dest), Cell_Y(dest),
+                    Cell_X(waypoint), Cell_Y(waypoint));
+            return 1;
+        }
+        return 0;
+    }
+    if (waypoint == dest) return 0;
+    Routed++;
+
+    /*
+     * Follow the waypoints. Each one must be reachable from the last, and the
+     * graph route to the destination gets shorter at every step, so this must
+     * end at the destination.
+     */
+    CELL cell = source;
+    int travelled = 0;
+    for (int leg = 0; cell != dest; leg++) {
+        CELL next = Incremental.Waypoint(cell, dest, check);
+        int cost = Flat_Path(cell, next, check);
+        if (cost < 0) {
+            fprintf(stderr, "zone %d, %d,%d to %d,%d: waypoint %d,%d is off the way\n",
+                    check, Cell_X(source), Cell_Y(source), Cell_X(dest), Cell_Y(dest),
+                    Cell_X(next), Cell_Y(next));
+            return 1;
+        }
+        if (leg > 200) {
+            fprintf(stderr, "zone %d, %d,%d to %d,%d: waypoints never reach the destination\n",
+                    check, Cell_X(source), Cell_Y(source), Cell_X(dest), Cell_Y(dest));
+            return 1;
+        }
+        travelled += cost;
+        cell = next;
+    }
+
+    double stretch = (double)travelled / best;
+    TotalStretch += stretch;
+    if (stretch > WorstStretch) WorstStretch = stretch;
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int seeds = argc > 1 ? atoi(argv[1]) : 10;
+    int changes = argc > 2 ? atoi(argv[2]) : 40;
+
+    if (seeds <= 0 || changes <= 0) {
+        fprintf(stderr, "usage: %s [seeds] [changes]\n", argv[0]);
+        return 1;
+    }
+
+    long cells = 0;
+    for (int s = 1; s <= seeds; s++) {
+        Seed = (unsigned long)s;
+        Make_Map();
+        Incremental.Invalidate(MZONEF_ALL);
+        Fresh.Invalidate(MZONEF_ALL);
+
+        for (int c = 0; c <= changes; c++) {
+            if (c > 0) cells += Change_Cells();
+
+            for (int zone = MZONE_FIRST; zone < MZONE_COUNT; zone++) {
+                MZoneType check = (MZoneType)zone;
+                for (int t = 0; t < 8; t++) {
+                    if (Check_Trip(Random_Cell(check), Random_Cell(check), check)) {
+                        fprintf(stderr, "seed %d, change %d\n", s, c);
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    printf("%d maps, %ld cells changed, %ld trips\n", seeds, cells, Trips);
+    printf("%ld routed through the graph, %ld unreachable\n", Routed, Unreachable);
+    printf("waypoints cost %.2f times the flat path on average, %.2f at worst\n",
+           Routed ? TotalStretch / Routed : 0.0, WorstStretch);
+
+    if (Routed == 0 || Unreachable == 0) {
+        fprintf(stderr, "the maps never needed a route or never cut one off\n");
+        return 1;
+    }
+
+    /*
+     * The cluster centers make some single trips take the long way round, but
+     * on the whole the waypoints must stay close to the flat path.
+     */
+    if (TotalStretch / Routed > MEAN_STRETCH) {
+        fprintf(stderr, "the waypoints stray too far from the flat path\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * tests/profiler_thread_test.cpp - thread hand-off test for the profiler
+ *
+ * Every frame a batch of worker threads is started. Each one opens and
+ * closes nested zones and bumps a counter, then exits, while the main thread
+ * marks the end of the frame with Profiler.Frame(). The exiting threads
+ * retire their profiling data through the thread key destructor at the same
+ * time as Frame() gathers and frees the retired data. Every zone call and
+ * count must be gathered exactly once.
+ *
+ * The counts only show lost or doubled data. The race between a thread
+ * retiring and Frame() freeing its data shows up under ThreadSanitizer; see
+ * TESTS.md.
+ *
+ * The real CODE/BENCH.CPP is compiled in. Its function.h and jshell.h are
+ * kept out with the include guards; the enum increment that the profiler
+ * needs from jshell.h is supplied here.
+ *
+ * usage: profiler_thread_test [frames] [threads] [zones]
+ */
+
+#define FUNCTION_H
+#define JSHELL_H
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+template<class T> inline T operator ++(T & a, int)
+{
+    T aa = a;
+    a = (T)((int)a + (int)1);
+    return(aa);
+}
+
+#include "fixed.h"
+#include "defines.h"
+#include "bench.h"
+
+extern ProfilerClass Profiler;
+
+#include "BENCH.CPP"
+
+ProfilerClass Profiler;
+
+static int Zones;
+
+static void *worker(void *)
+{
+    for (int i = 0; i < Zones; i++) {
+        Profiler.Begin(BENCH_SAVE_WRITE);
+        Profiler.Begin(BENCH_SAVE_COMPRESS);
+        Profiler.Count(COUNT_FINDPATH);
+        Profiler.End(BENCH_SAVE_COMPRESS);
+        Profiler.End(BENCH_SAVE_WRITE);
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 200;
+    int nthreads = argc > 2 ? atoi(argv[2]) : 4;
+    Zones = argc > 3 ? atoi(argv[3]) : 100;
+
+    /* Calls() only covers the frame history, so every frame must still be in it. */
+    if (frames <= 0 || frames >= 512 || nthreads <= 0 || nthreads > 64 || Zones <= 0) {
+        fprintf(stderr, "usage: %s [frames 1-511] [threads 1-64] [zones]\n", argv[0]);
+        return 1;
+    }
+
+    Profiler.Enable(NULL, 0);
+    for (int f = 0; f < frames; f++) {
+        pthread_t threads[64];
+        for (int i = 0; i < nthreads; i++) {
+            if (pthread_create(&threads[i], NULL, worker, NULL) != 0) {
+                fprintf(stderr, "can't start thread %d\n", i);
+                return 1;
+            }
+        }
+        Profiler.Begin(BENCH_GAME_FRAME);
+        Profiler.Frame();
+        for (int i = 0; i < nthreads; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+
+    /* Gathers what the last batch recorded after the last frame. */
+    Profiler.Frame();
+
+    unsigned long expect = (unsigned long)frames * nthreads * Zones;
+    unsigned long compress = Profiler.Calls(BENCH_SAVE_COMPRESS);
+    unsigned long write = Profiler.Calls(BENCH_SAVE_WRITE);
+    long counted = Profiler.Take_Count(COUNT_FINDPATH);
+    unsigned long game = Profiler.Calls(BENCH_GAME_FRAME);
+
+    printf("%d frames of %d threads with %d zones each\n", frames, nthreads, Zones);
+    printf("zone calls %lu and %lu, counted %ld, expected %lu; %lu game frames\n",
+           compress, write, counted, expect, game);
+
+    if (compress != expect || write != expect || (unsigned long)counted != expect) {
+        fprintf(stderr, "zone calls or counts were lost or gathered twice\n");
+        return 1;
+    }
+    if (game != (unsigned long)frames) {
+        fprintf(stderr, "%lu game frame zones, expected %d\n", game, frames);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,474 @@
+/*
+ * tests/render_snapshot_test.cpp - in-between frame test for the render snapshot
+ *
+ * Plays a number of logic ticks over a field of units, infantry and buildings
+ * in the order Main_Loop uses: draw, logic, RenderSnapshotClass::Capture, then
+ * the frame delay in Sync_Delay with an Interpolate and a draw on every pass,
+ * and a Settle at the end. Each tick most units take a short step, some jump
+ * a long way, some are removed and new ones arrive (often in the memory of an
+ * old one). A stand-in display redraws an object whenever it is marked or a
+ * cell under it is refreshed, at the position ObjectClass::Render_Coord would
+ * give. Checked on every draw:
+ *
+ *   - every object is on screen where the snapshot says it should be, so no
+ *     stale image is left behind, and the cell it left was refreshed;
+ *   - an object that took a short step starts the delay at its old position,
+ *     only moves toward the new one and never past it;
+ *   - buildings, objects that jumped, new arrivals and objects that did not
+ *     move stay at their true position;
+ *   - once settled, everything is drawn at its true position again.
+ *
+ * The real CODE/SNAPSHOT.CPP, VECTOR.CPP and DYNAVEC.CPP are compiled in.
+ * Their function.h and jshell.h are kept out with the include guards; the
+ * coordinate helpers and a stand-in for each game class the snapshot uses
+ * are supplied here.
+ *
+ * usage: render_snapshot_test [seeds] [ticks]
+ */
+
+#define FUNCTION_H
+#define JSHELL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * glibc's <endian.h> defines BIG_ENDIAN as a byte order constant on every
+ * machine, which would flip the coordinate unions in defines.h.
+ */
+#undef BIG_ENDIAN
+
+class NoInitClass {
+	public:
+		void operator () (void) const {};
+};
+
+static inline void Set_Bit(void *array, int bit, int value)
+{
+    unsigned char *p = (unsigned char *)array + (bit >> 3);
+    if (value) *p |= (unsigned char)(1 << (bit & 7));
+    else       *p &= (unsigned char)~(1 << (bit & 7));
+}
+
+static inline int Get_Bit(const void *array, int bit)
+{
+    return (((const unsigned char *)array)[bit >> 3] >> (bit & 7)) & 1;
+}
+
+static inline int First_True_Bit(const void *array)
+{
+    const uint32_t *d = (const uint32_t *)array;
+    int offset = 0;
+    while (*d == 0u) { ++d; offset += 32; }
+    return offset + __builtin_ctz(*d);
+}
+
+static inline int First_False_Bit(const void *array)
+{
+    const uint32_t *d = (const uint32_t *)array;
+    int offset = 0;
+    while (*d == 0xFFFFFFFFu) { ++d; offset += 32; }
+    return offset + __builtin_ctz(~*d);
+}
+
+template<class T> inline T operator ++(T & a, int)
+{
+    T aa = a;
+    a = (T)((int)a + (int)1);
+    return(aa);
+}
+
+template<class T> T Bound(T original, T minval, T maxval)
+{
+    if (original < minval) return(minval);
+    if (original > maxval) return(maxval);
+    return(original);
+}
+
+#include "fixed.h"
+#include "defines.h"
+#include "pipe.h"
+#include "straw.h"
+#include "vector.h"
+#include "VECTOR.CPP"
+#include "DYNAVEC.CPP"
+
+/* ---- Coordinate helpers, as in inline.h and COORD.CPP ---- */
+
+#define ICON_PIXEL_W    24
+#define ICON_LEPTON_W   256
+#define CELL_LEPTON_W   ICON_LEPTON_W
+
+inline int Lepton_To_Pixel(LEPTON lepton)
+{
+    return (((int)(signed short)lepton * ICON_PIXEL_W) + (ICON_LEPTON_W / 2)) / ICON_LEPTON_W;
+}
+
+inline COORDINATE XY_Coord(LEPTON x, LEPTON y)
+{
+    return ((COORDINATE)y << 16) | x;
+}
+
+inline LEPTON Coord_X(COORDINATE coord)
+{
+    return (LEPTON)(coord & 0xFFFF);
+}
+
+inline LEPTON Coord_Y(COORDINATE coord)
+{
+    return (LEPTON)((coord >> 16) & 0xFFFF);
+}
+
+inline CELL Coord_Cell(COORDINATE coord)
+{
+    return (CELL)((Coord_Y(coord) >> 8) * MAP_CELL_W + (Coord_X(coord) >> 8));
+}
+
+int Distance(COORDINATE coord1, COORDINATE coord2)
+{
+    int diff1 = Coord_Y(coord1) - Coord_Y(coord2);
+    if (diff1 < 0) diff1 = -diff1;
+    int diff2 = Coord_X(coord1) - Coord_X(coord2);
+    if (diff2 < 0) diff2 = -diff2;
+    if (diff1 > diff2) {
+        return(diff1 + ((unsigned)diff2 / 2));
+    }
+    return(diff2 + ((unsigned)diff1 / 2));
+}
+
+/*
+ * The cell and the eight around it. An image that is a pixel away from where it
+ * was can be in the next cell over, so the real list is never just the cell.
+ */
+short const * Coord_Spillage_List(COORDINATE, int)
+{
+    static short const _list[] = {
+        0, -1, 1, -MAP_CELL_W, MAP_CELL_W,
+        -MAP_CELL_W-1, -MAP_CELL_W+1, MAP_CELL_W-1, MAP_CELL_W+1, REFRESH_EOL
+    };
+    return _list;
+}
+
+/* ---- Stand-ins for the game classes the snapshot looks at ---- */
+
+static int FrameTimer;
+
+class ObjectClass {
+    public:
+        RTTIType RTTI;
+        COORDINATE Coord;
+        bool IsActive;
+        bool IsDirty;               /* Marked for redraw. */
+        COORDINATE Screen;          /* Where the stand-in display last drew it. */
+
+        RTTIType What_Am_I(void) const { return RTTI; }
+        COORDINATE Center_Coord(void) const { return Coord; }
+        bool Mark(MarkType) { IsDirty = true; return true; }
+};
+
+#define OBJECT_MAX  200
+
+struct LayerStandIn {
+    ObjectClass * Objects[OBJECT_MAX];
+    int Total;
+
+    int Count(void) const { return Total; }
+    ObjectClass * operator [] (int index) { return Objects[index]; }
+};
+
+struct MapStandIn {
+    LayerStandIn Layer[LAYER_COUNT];
+    bool Refreshed[MAP_CELL_TOTAL];
+
+    void Refresh_Cells(CELL cell, short const * list)
+    {
+        for (; *list != REFRESH_EOL; list++) {
+            Refreshed[cell + *list] = true;
+        }
+    }
+};
+
+static MapStandIn Map;
+
+#include "snapshot.h"
+#include "SNAPSHOT.CPP"
+
+static RenderSnapshotClass RenderSnapshot;
+
+/* ---- The game objects and what the test knows about them ---- */
+
+static ObjectClass Pool[OBJECT_MAX];
+
+/*
+ * How each object got to where it is this tick, and what its position was at
+ * the end of the last tick.
+ */
+enum StepType { STILL, STEPPED, JUMPED, ARRIVED };
+
+static StepType Step[OBJECT_MAX];
+static COORDINATE Before[OBJECT_MAX];
+static COORDINATE Last[OBJECT_MAX];     /* Snapshot position on the previous pass. */
+
+static unsigned long Seed;
+
+static int Random(int range)
+{
+    Seed = Seed * 1103515245UL + 12345UL;
+    return (int)((Seed >> 16) & 0x7FFF) % range;
+}
+
+static COORDINATE Random_Coord(void)
+{
+    return XY_Coord((LEPTON)(0x1000 + Random(0x6000)), (LEPTON)(0x1000 + Random(0x6000)));
+}
+
+static int Pixel_X(COORDINATE coord) { return Lepton_To_Pixel(Coord_X(coord)); }
+static int Pixel_Y(COORDINATE coord) { return Lepton_To_Pixel(Coord_Y(coord)); }
+
+static bool Same_Pixel(COORDINATE a, COORDINATE b)
+{
+    return Pixel_X(a) == Pixel_X(b) && Pixel_Y(a) == Pixel_Y(b);
+}
+
+static void Add_Object(int index)
+{
+    ObjectClass & object = Pool[index];
+    int kind = Random(10);
+    object.RTTI = kind == 0 ? RTTI_BUILDING : (kind < 4 ? RTTI_INFANTRY : RTTI_UNIT);
+
+    /*
+     * The snapshot can only tell a new object in old memory apart from the old
+     * one by how far apart they are.
+     */
+    COORDINATE old = object.Coord;
+    do {
+        object.Coord = Random_Coord();
+    } while (old != 0 && Distance(old, object.Coord) < CELL_LEPTON_W);
+    object.IsActive = true;
+    object.IsDirty = true;
+    object.Screen = object.Coord;
+    Step[index] = ARRIVED;
+
+    LayerStandIn & layer = Map.Layer[LAYER_GROUND];
+    layer.Objects[layer.Total++] = &object;
+}
+
+static void Remove_Object(int index)
+{
+    ObjectClass & object = Pool[index];
+    LayerStandIn & layer = Map.Layer[LAYER_GROUND];
+
+    for (int i = 0; i < layer.Total; i++) {
+        if (layer.Objects[i] == &object) {
+            layer.Objects[i] = layer.Objects[--layer.Total];
+            break;
+        }
+    }
+    Map.Refreshed[Coord_Cell(object.Screen)] = true;
+    object.IsActive = false;
+}
+
+/*
+ * One tick of game logic. Moving objects mark themselves and refresh the cell
+ * they were drawn in, as the game's own movement does.
+ */
+static void Logic(void)
+{
+    for (int index = 0; index < OBJECT_MAX; index++) {
+        ObjectClass & object = Pool[index];
+        Before[index] = object.Coord;
+
+        if (!object.IsActive) {
+            if (Random(8) == 0) Add_Object(index);
+            continue;
+        }
+        if (Random(40) == 0) {
+            Remove_Object(index);
+
+            /* A new object often takes over the memory of the old one right away. */
+            if (Random(2) == 0) Add_Object(index);
+            continue;
+        }
+
+        Step[index] = STILL;
+        if (object.RTTI == RTTI_BUILDING) continue;
+
+        int roll = Random(20);
+        COORDINATE to = object.Coord;
+        if (roll == 0) {
+            to = Random_Coord();
+            if (Distance(object.Coord, to) < CELL_LEPTON_W) to = object.Coord;
+            else Step[index] = JUMPED;
+        } else if (roll < 16) {
+            int x = Bound(Coord_X(object.Coord) + Random(160) - 80, 0x0800, 0x7800);
+            int y = Bound(Coord_Y(object.Coord) + Random(160) - 80, 0x0800, 0x7800);
+            to = XY_Coord((LEPTON)x, (LEPTON)y);
+            Step[index] = to == object.Coord ? STILL : STEPPED;
+        }
+        if (to != object.Coord) {
+            Map.Refreshed[Coord_Cell(object.Screen)] = true;
+            object.Coord = to;
+            object.IsDirty = true;
+        }
+    }
+}
+
+/*
+ * Draws what needs drawing, at the position ObjectClass::Render_Coord gives,
+ * then checks that the screen matches the snapshot everywhere. Returns zero
+ * if it does.
+ */
+static int Draw(void)
+{
+    for (int index = 0; index < OBJECT_MAX; index++) {
+        ObjectClass & object = Pool[index];
+        if (!object.IsActive) continue;
+
+        if (object.IsDirty || Map.Refreshed[Coord_Cell(object.Screen)]) {
+            COORDINATE coord = RenderSnapshot.Coord_Of(&object, object.Center_Coord());
+            if (!Same_Pixel(coord, object.Screen) && !Map.Refreshed[Coord_Cell(object.Screen)]) {
+                fprintf(stderr, "object %d moved on screen without its old cell being refreshed\n", index);
+                return 1;
+            }
+            object.Screen = coord;
+            object.IsDirty = false;
+        }
+    }
+    memset(Map.Refreshed, 0, sizeof(Map.Refreshed));
+
+    for (int index = 0; index < OBJECT_MAX; index++) {
+        ObjectClass & object = Pool[index];
+        if (!object.IsActive) continue;
+
+        COORDINATE coord = RenderSnapshot.Coord_Of(&object, object.Center_Coord());
+        if (!Same_Pixel(coord, object.Screen)) {
+            fprintf(stderr, "object %d is drawn at %d,%d but belongs at %d,%d\n", index,
+                    Pixel_X(object.Screen), Pixel_Y(object.Screen), Pixel_X(coord), Pixel_Y(coord));
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static bool Between(int value, int from, int to)
+{
+    return from <= to ? (value >= from && value <= to) : (value <= from && value >= to);
+}
+
+static long Slid;
+
+/*
+ * Checks where the snapshot puts each object on an in-between pass. Returns
+ * zero if everything is where it should be.
+ */
+static int Check_Pass(bool first)
+{
+    for (int index = 0; index < OBJECT_MAX; index++) {
+        ObjectClass & object = Pool[index];
+        if (!object.IsActive) continue;
+
+        COORDINATE coord = RenderSnapshot.Coord_Of(&object, object.Center_Coord());
+        if (Step[index] != STEPPED) {
+            if (coord != object.Coord) {
+                fprintf(stderr, "object %d (step %d) is not at its true position\n", index, Step[index]);
+                return 1;
+            }
+            continue;
+        }
+
+        COORDINATE from = Before[index];
+        COORDINATE to = object.Coord;
+        if (first && coord != from) {
+            fprintf(stderr, "object %d does not start from its old position\n", index);
+            return 1;
+        }
+        if (!Between(Coord_X(coord), Coord_X(from), Coord_X(to)) ||
+            !Between(Coord_Y(coord), Coord_Y(from), Coord_Y(to))) {
+            fprintf(stderr, "object %d is off the line between its positions\n", index);
+            return 1;
+        }
+        if (!first && Distance(from, coord) < Distance(from, Last[index])) {
+            fprintf(stderr, "object %d moved back toward its old position\n", index);
+            return 1;
+        }
+        if (coord != from) Slid++;
+        Last[index] = coord;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int seeds = argc > 1 ? atoi(argv[1]) : 20;
+    int ticks = argc > 2 ? atoi(argv[2]) : 200;
+
+    if (seeds <= 0 || ticks <= 0) {
+        fprintf(stderr, "usage: %s [seeds] [ticks]\n", argv[0]);
+        return 1;
+    }
+
+    long passes = 0;
+    for (int s = 1; s <= seeds; s++) {
+        Seed = (unsigned long)s;
+        memset(Pool, 0, sizeof(Pool));
+        memset(&Map, 0, sizeof(Map));
+        RenderSnapshot.Clear();
+        for (int index = 0; index < OBJECT_MAX / 2; index++) {
+            Add_Object(index);
+        }
+
+        for (int t = 0; t < ticks; t++) {
+            /*
+             * Main_Loop draws first, then runs the logic, then captures the
+             * snapshot and waits out the frame in Sync_Delay.
+             */
+            if (Draw()) {
+                fprintf(stderr, "seed %d, tick %d, after settling\n", s, t);
+                return 1;
+            }
+
+            Logic();
+            FrameTimer = 1 + Random(8);
+            RenderSnapshot.Capture();
+
+            /* The tick before the first capture has no earlier snapshot to slide from. */
+            if (t == 0) {
+                for (int index = 0; index < OBJECT_MAX; index++) {
+                    if (Step[index] == STEPPED) Step[index] = ARRIVED;
+                }
+            }
+
+            bool first = true;
+            while (FrameTimer > 0) {
+                RenderSnapshot.Interpolate();
+                if (Check_Pass(first) || Draw()) {
+                    fprintf(stderr, "seed %d, tick %d, %d ticks left\n", s, t, FrameTimer);
+                    return 1;
+                }
+                passes++;
+                first = false;
+                FrameTimer -= 1 + Random(2);
+                if (FrameTimer < 0) FrameTimer = 0;
+            }
+            RenderSnapshot.Settle();
+
+            for (int index = 0; index < OBJECT_MAX; index++) {
+                ObjectClass & object = Pool[index];
+                if (object.IsActive && RenderSnapshot.Coord_Of(&object, object.Coord) != object.Coord) {
+                    fprintf(stderr, "seed %d, tick %d: object %d is not back at its true position\n", s, t, index);
+                    return 1;
+                }
+            }
+        }
+    }
+
+    printf("%d seeds of %d ticks, %ld in-between passes, %ld objects drawn part way\n",
+           seeds, ticks, passes, Slid);
+    if (Slid == 0) {
+        fprintf(stderr, "nothing was ever drawn part way\n");
+        return 1;
+    }
+    return 0;
+}
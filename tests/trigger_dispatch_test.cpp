@@ -0,0 +1,627 @@
+/*
+ * tests/trigger_dispatch_test.cpp - firing order test for the logic trigger dispatcher
+ *
+ * Builds a scenario of random logic triggers (globals, bridges, the mission
+ * timer, elapsed time, polled credits, attacks from outside, triggers that
+ * force other triggers, every persistence mode) and plays it twice: once with
+ * the logic trigger list scan that LogicClass::AI used to make every frame
+ * and once with TriggerDispatchClass::Process. The frame and ID of every
+ * trigger that fires must be the same in both runs.
+ *
+ * The old scan stepped back one slot whenever a trigger was deleted (the
+ * LogicTriggerID-- in ~TriggerClass), even when the deleted trigger was
+ * further down the list, so the trigger being examined got examined again.
+ * The dispatcher reproduces that in Back_Up. The test counts how often the
+ * old scan did it and fails if no seed got there. Seeds where the old scan
+ * stepped off the front of the list are skipped; the game would have read
+ * LogicTriggers[-1] there.
+ *
+ * The real CODE/TRIGDISP.CPP, VECTOR.CPP and DYNAVEC.CPP are compiled in.
+ * Their function.h and jshell.h are kept out with the include guards; the
+ * bit helpers and a stand-in for each game class the dispatcher uses are
+ * supplied here.
+ *
+ * usage: trigger_dispatch_test [seeds] [frames]
+ */
+
+#define FUNCTION_H
+#define JSHELL_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+class NoInitClass {
+	public:
+		void operator () (void) const {};
+};
+
+static inline void Set_Bit(void *array, int bit, int value)
+{
+    unsigned char *p = (unsigned char *)array + (bit >> 3);
+    if (value) *p |= (unsigned char)(1 << (bit & 7));
+    else       *p &= (unsigned char)~(1 << (bit & 7));
+}
+
+static inline int Get_Bit(const void *array, int bit)
+{
+    return (((const unsigned char *)array)[bit >> 3] >> (bit & 7)) & 1;
+}
+
+static inline int First_True_Bit(const void *array)
+{
+    const uint32_t *d = (const uint32_t *)array;
+    int offset = 0;
+    while (*d == 0u) { ++d; offset += 32; }
+    return offset + __builtin_ctz(*d);
+}
+
+static inline int First_False_Bit(const void *array)
+{
+    const uint32_t *d = (const uint32_t *)array;
+    int offset = 0;
+    while (*d == 0xFFFFFFFFu) { ++d; offset += 32; }
+    return offset + __builtin_ctz(~*d);
+}
+
+#include "pipe.h"
+#include "straw.h"
+#include "vector.h"
+#include "VECTOR.CPP"
+#include "DYNAVEC.CPP"
+
+/* ---- Stand-ins for the game classes the dispatcher looks at ---- */
+
+static long Frame;
+
+typedef enum TEventType {
+    TEVENT_NONE,
+    TEVENT_PLAYER_ENTERED,
+    TEVENT_SPIED,
+    TEVENT_ATTACKED,
+    TEVENT_DESTROYED,
+    TEVENT_DISCOVERED,
+    TEVENT_CROSS_HORIZONTAL,
+    TEVENT_CROSS_VERTICAL,
+    TEVENT_ENTERS_ZONE,
+    TEVENT_CREDITS,
+    TEVENT_GLOBAL_SET,
+    TEVENT_GLOBAL_CLEAR,
+    TEVENT_MISSION_TIMER_EXPIRED,
+    TEVENT_TIME,
+    TEVENT_ALL_BRIDGES_DESTROYED,
+    TEVENT_ANY
+} TEventType;
+
+typedef enum MultiStyleType {
+    MULTI_ONLY,
+    MULTI_AND,
+    MULTI_OR,
+    MULTI_LINKED
+} MultiStyleType;
+
+/* Counts down with the frame number, like CDTimerClass<FrameTimerClass>. */
+class FrameTimer {
+    public:
+        FrameTimer(long value = 0) : Started(Frame), Delay(value), Active(true) {}
+        FrameTimer & operator = (long value) { Delay = value; Started = Frame; Active = true; return *this; }
+        operator long () const {
+            if (!Active) return Delay;
+            long left = Delay - (Frame - Started);
+            return left > 0 ? left : 0;
+        }
+        bool Is_Active(void) const { return Active; }
+        void Stop(void) { Delay = (long)*this; Active = false; }
+
+    private:
+        long Started;
+        long Delay;
+        bool Active;
+};
+
+struct TDEventClass {
+    TDEventClass() : IsTripped(false), Timer(0) {}
+    unsigned IsTripped:1;
+    FrameTimer Timer;
+};
+
+struct TEventClass {
+    void Reset(TDEventClass & td) const;
+    bool operator () (TDEventClass & td, TEventType event, bool forced) const;
+
+    TEventType Event;
+    struct {
+        int Value;
+    } Data;
+};
+
+enum ActionKind {
+    ACT_NOTHING,
+    ACT_SET_GLOBAL,
+    ACT_CLEAR_GLOBAL,
+    ACT_DESTROY_BRIDGE,
+    ACT_MISSION_TIMER_ZERO,
+    ACT_MISSION_TIMER_START,
+    ACT_FORCE_TRIGGER,
+    ACT_FAIL,
+    ACT_COUNT
+};
+
+struct TriggerTypeClass {
+    enum PersistantType { VOLATILE, SEMIPERSISTANT, PERSISTANT };
+
+    TEventClass Event1;
+    TEventClass Event2;
+    MultiStyleType EventControl;
+    PersistantType IsPersistant;
+    ActionKind Action;
+    int ActionData;
+};
+
+struct TriggerClass {
+    bool Spring(TEventType event = TEVENT_ANY, bool forced = false);
+
+    int ID;
+    TriggerTypeClass * Class;
+    TDEventClass Event1;
+    TDEventClass Event2;
+    bool IsActive;
+    int AttachCount;
+};
+
+enum { GLOBAL_COUNT = 30 };
+
+struct ScenarioStandIn {
+    bool Set_Global_To(int global, bool value);
+
+    bool GlobalFlags[GLOBAL_COUNT];
+    bool IsGlobalChanged;
+    bool IsBridgeChanged;
+    int BridgeCount;
+    FrameTimer MissionTimer;
+    long Credits;
+};
+
+enum { TRIGGER_COUNT = 120 };
+
+struct TriggerHeapStandIn {
+    int Length(void) const { return TRIGGER_COUNT; }
+};
+
+static ScenarioStandIn Scen;
+static TriggerHeapStandIn Triggers;
+static DynamicVectorClass<TriggerClass *> LogicTriggers;
+
+#include "trigdisp.h"
+#include "TRIGDISP.CPP"
+
+static TriggerDispatchClass TriggerDispatch;
+
+/* ---- The scenario ---- */
+
+static TriggerTypeClass Types[TRIGGER_COUNT];
+static TriggerClass Pool[TRIGGER_COUNT];
+
+static bool UseDispatch;
+static bool InScan;             /* The old scan is walking the list. */
+static int LogicTriggerID;      /* Its position in the list. */
+static bool SteppedOffFront;
+static long Examined;
+static long StepBacks;          /* Deletions further down the list during the old scan. */
+
+struct Firing {
+    long Frame;
+    int ID;
+};
+
+static Firing *Log;
+static int LogCount;
+static int LogMax;
+
+static void Record(int id)
+{
+    if (LogCount == LogMax) {
+        LogMax = LogMax ? LogMax * 2 : 1024;
+        Log = (Firing *)realloc(Log, LogMax * sizeof(Firing));
+        if (Log == NULL) {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    Log[LogCount].Frame = Frame;
+    Log[LogCount].ID = id;
+    LogCount++;
+}
+
+static uint32_t rng_state;
+
+static int rng(int range)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return (int)(rng_state % (uint32_t)range);
+}
+
+void TEventClass::Reset(TDEventClass & td) const
+{
+    td.IsTripped = false;
+    if (Event == TEVENT_TIME) td.Timer = Data.Value;
+}
+
+/* The same checks as TEventClass::operator () for the events used here. */
+bool TEventClass::operator () (TDEventClass & td, TEventType event, bool forced) const
+{
+    if (forced) td.IsTripped = true;
+    if (td.IsTripped) return true;
+
+    switch (Event) {
+        case TEVENT_GLOBAL_SET:
+            return Scen.GlobalFlags[Data.Value];
+
+        case TEVENT_GLOBAL_CLEAR:
+            return !Scen.GlobalFlags[Data.Value];
+
+        case TEVENT_MISSION_TIMER_EXPIRED:
+            return Scen.MissionTimer.Is_Active() && Scen.MissionTimer == 0;
+
+        case TEVENT_TIME:
+            return td.Timer == 0;
+
+        case TEVENT_ATTACKED:
+            if (event != Event && event != TEVENT_ANY) return false;
+            td.IsTripped = true;
+            return true;
+
+        case TEVENT_ALL_BRIDGES_DESTROYED:
+            if (Scen.BridgeCount) return false;
+            td.IsTripped = true;
+            return true;
+
+        case TEVENT_CREDITS:
+            return Scen.Credits >= Data.Value;
+
+        default:
+            break;
+    }
+    return false;
+}
+
+/* As ScenarioClass::Set_Global_To, including its elapsed time reset. */
+bool ScenarioStandIn::Set_Global_To(int global, bool value)
+{
+    bool previous = GlobalFlags[global];
+    if (previous != value) {
+        GlobalFlags[global] = value;
+        IsGlobalChanged = true;
+        if (UseDispatch) TriggerDispatch.Notify(value ? TEVENT_GLOBAL_SET : TEVENT_GLOBAL_CLEAR);
+
+        for (int index = 0; index < TRIGGER_COUNT; index++) {
+            TriggerClass * tp = &Pool[index];
+            if (!tp->IsActive) continue;
+            if ((tp->Class->Event1.Event == TEVENT_GLOBAL_SET || tp->Class->Event1.Event == TEVENT_GLOBAL_CLEAR) && tp->Class->Event1.Data.Value == global) {
+                tp->Class->Event2.Reset(tp->Event1);
+            }
+            if ((tp->Class->Event2.Event == TEVENT_GLOBAL_SET || tp->Class->Event2.Event == TEVENT_GLOBAL_CLEAR) && tp->Class->Event2.Data.Value == global) {
+                tp->Class->Event1.Reset(tp->Event1);
+            }
+        }
+    }
+    return previous;
+}
+
+/* LogicClass::Detach followed by ~TriggerClass, as they were before the dispatcher. */
+static void Delete_Trigger(TriggerClass * trigger)
+{
+    int position = LogicTriggers.ID(trigger);
+    if (InScan && position > LogicTriggerID) StepBacks++;
+
+    for (int index = 0; index < LogicTriggers.Count(); index++) {
+        if (LogicTriggers[index] == trigger) {
+            if (UseDispatch) TriggerDispatch.Remove(trigger);
+            LogicTriggers.Delete(index);
+            index--;
+        }
+    }
+    trigger->IsActive = false;
+
+    if (LogicTriggerID >= LogicTriggers.ID(trigger)) {
+        LogicTriggerID--;
+        if (LogicTriggerID < 0 && LogicTriggers.Count() == 0) {
+            LogicTriggerID = 0;
+        }
+    }
+}
+
+static bool Do_Action(TriggerClass * trigger)
+{
+    TriggerTypeClass * tp = trigger->Class;
+
+    Record(trigger->ID);
+    switch (tp->Action) {
+        case ACT_SET_GLOBAL:
+            Scen.Set_Global_To(tp->ActionData, true);
+            break;
+
+        case ACT_CLEAR_GLOBAL:
+            Scen.Set_Global_To(tp->ActionData, false);
+            break;
+
+        case ACT_DESTROY_BRIDGE:
+            if (Scen.BridgeCount > 0) {
+                Scen.BridgeCount--;
+                Scen.IsBridgeChanged = true;
+                if (UseDispatch) TriggerDispatch.Notify(TEVENT_ALL_BRIDGES_DESTROYED);
+            }
+            break;
+
+        case ACT_MISSION_TIMER_ZERO:
+            Scen.MissionTimer = 0;
+            break;
+
+        case ACT_MISSION_TIMER_START:
+            Scen.MissionTimer = tp->ActionData;
+            break;
+
+        case ACT_FORCE_TRIGGER:
+            if (Pool[tp->ActionData].IsActive) Pool[tp->ActionData].Spring(TEVENT_ANY, true);
+            break;
+
+        case ACT_FAIL:
+            return false;
+
+        default:
+            break;
+    }
+    return true;
+}
+
+/* The parts of TriggerClass::Spring that decide whether it goes off and what becomes of it. */
+bool TriggerClass::Spring(TEventType event, bool forced)
+{
+    if (UseDispatch) TriggerDispatch.Touch(this);
+    Examined++;
+
+    bool e1 = Class->Event1(Event1, event, forced);
+    bool execute = false;
+    if (!forced) {
+        switch (Class->EventControl) {
+            case MULTI_ONLY:
+                execute = e1;
+                break;
+
+            case MULTI_AND:
+                execute = Class->Event2(Event2, event, forced) && e1;
+                break;
+
+            default:
+                execute = Class->Event2(Event2, event, forced) || e1;
+                break;
+        }
+    }
+
+    if (execute || forced) {
+        if (Class->IsPersistant == TriggerTypeClass::SEMIPERSISTANT) {
+            AttachCount--;
+            if (AttachCount > 0) return false;
+        }
+
+        bool ok = Do_Action(this);
+        if (!IsActive) return true;
+
+        if (ok) {
+            if (Class->IsPersistant == TriggerTypeClass::VOLATILE ||
+                (Class->IsPersistant == TriggerTypeClass::SEMIPERSISTANT && AttachCount <= 1)) {
+                Delete_Trigger(this);
+                return true;
+            }
+            Class->Event1.Reset(Event1);
+            Class->Event2.Reset(Event2);
+        }
+    }
+    return false;
+}
+
+/* The logic trigger scan that LogicClass::AI made before the dispatcher. */
+static void Scan_Logic_Triggers(void)
+{
+    InScan = true;
+    for (LogicTriggerID = 0; LogicTriggerID < LogicTriggers.Count(); LogicTriggerID++) {
+        if (LogicTriggerID < 0) {
+            SteppedOffFront = true;
+            InScan = false;
+            return;
+        }
+        TriggerClass * trig = LogicTriggers[LogicTriggerID];
+
+        if (Scen.IsGlobalChanged) {
+            if (trig->Spring(TEVENT_GLOBAL_SET)) continue;
+            if (trig->Spring(TEVENT_GLOBAL_CLEAR)) continue;
+        }
+        if (Scen.IsBridgeChanged) {
+            if (trig->Spring(TEVENT_ALL_BRIDGES_DESTROYED)) continue;
+        }
+        if (trig->Spring(TEVENT_TIME)) continue;
+        if (Scen.MissionTimer.Is_Active() && Scen.MissionTimer == 0) {
+            if (trig->Spring(TEVENT_MISSION_TIMER_EXPIRED)) continue;
+        }
+    }
+    InScan = false;
+}
+
+static TEventType Random_Event(void)
+{
+    static const TEventType events[] = {
+        TEVENT_TIME, TEVENT_TIME, TEVENT_TIME, TEVENT_TIME,
+        TEVENT_GLOBAL_SET, TEVENT_GLOBAL_SET, TEVENT_GLOBAL_CLEAR,
+        TEVENT_MISSION_TIMER_EXPIRED, TEVENT_ALL_BRIDGES_DESTROYED,
+        TEVENT_CREDITS, TEVENT_ATTACKED, TEVENT_NONE
+    };
+    return events[rng(sizeof(events) / sizeof(events[0]))];
+}
+
+static int Random_Data(TEventType event)
+{
+    switch (event) {
+        case TEVENT_TIME:    return 1 + rng(600);
+        case TEVENT_CREDITS: return rng(2000);
+        default:             return rng(GLOBAL_COUNT);
+    }
+}
+
+/*
+ * Plays one scenario. The triggers and the outside events come from their own
+ * random streams, so both runs of a seed see exactly the same world. Returns
+ * false if the old scan stepped off the front of the list.
+ */
+static bool Play(uint32_t seed, int frames, bool dispatch)
+{
+    UseDispatch = dispatch;
+    SteppedOffFront = false;
+    LogCount = 0;
+    Frame = 0;
+
+    for (int global = 0; global < GLOBAL_COUNT; global++) Scen.GlobalFlags[global] = false;
+    Scen.IsGlobalChanged = false;
+    Scen.IsBridgeChanged = false;
+    Scen.BridgeCount = 3;
+    Scen.Credits = 0;
+    Scen.MissionTimer = 0;
+    Scen.MissionTimer.Stop();
+
+    LogicTriggers.Clear();
+    rng_state = seed * 2654435761u | 1;
+    for (int index = 0; index < TRIGGER_COUNT; index++) {
+        TriggerTypeClass & type = Types[index];
+        type.Event1.Event = Random_Event();
+        type.Event1.Data.Value = Random_Data(type.Event1.Event);
+        type.Event2.Event = Random_Event();
+        type.Event2.Data.Value = Random_Data(type.Event2.Event);
+        type.EventControl = (MultiStyleType)rng(4);
+        type.IsPersistant = (TriggerTypeClass::PersistantType)rng(3);
+        type.Action = (ActionKind)rng(ACT_COUNT);
+
+        /*
+         * A trigger only forces one further down the list, so that forcing can't
+         * go round in a circle. A forced trigger that deletes itself is also what
+         * makes the old scan step back.
+         */
+        if (type.Action == ACT_FORCE_TRIGGER && index == TRIGGER_COUNT - 1) type.Action = ACT_NOTHING;
+        switch (type.Action) {
+            case ACT_FORCE_TRIGGER:       type.ActionData = index + 1 + rng(TRIGGER_COUNT - 1 - index); break;
+            case ACT_MISSION_TIMER_START: type.ActionData = rng(300); break;
+            default:                      type.ActionData = rng(GLOBAL_COUNT); break;
+        }
+
+        TriggerClass & trigger = Pool[index];
+        trigger.ID = index;
+        trigger.Class = &type;
+        trigger.IsActive = true;
+        trigger.AttachCount = 1 + rng(3);
+        type.Event1.Reset(trigger.Event1);
+        type.Event2.Reset(trigger.Event2);
+        LogicTriggers.Add(&trigger);
+    }
+
+    TriggerDispatch.Clear();
+    if (dispatch) TriggerDispatch.Rebuild();
+
+    uint32_t world = rng_state;
+    for (Frame = 0; Frame < frames; Frame++) {
+        rng_state = world + (uint32_t)Frame * 7919u;
+        if (rng(20) == 0) Scen.Set_Global_To(rng(GLOBAL_COUNT), rng(2) != 0);
+        if (rng(15) == 0) {
+            TriggerClass & trigger = Pool[rng(TRIGGER_COUNT)];
+            if (trigger.IsActive) trigger.Spring(TEVENT_ATTACKED);
+        }
+        if (rng(10) == 0) Scen.Credits = rng(2500);
+        if (rng(200) == 0) Scen.MissionTimer = rng(100);
+
+        if (dispatch) {
+            TriggerDispatch.Process();
+        } else {
+            Scan_Logic_Triggers();
+            if (SteppedOffFront) return false;
+        }
+
+        if (Scen.MissionTimer.Is_Active() && Scen.MissionTimer == 0) Scen.MissionTimer.Stop();
+        Scen.IsGlobalChanged = false;
+        Scen.IsBridgeChanged = false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    int seeds = argc > 1 ? atoi(argv[1]) : 40;
+    int frames = argc > 2 ? atoi(argv[2]) : 3000;
+
+    if (seeds <= 0 || frames <= 0) {
+        fprintf(stderr, "usage: %s [seeds] [frames]\n", argv[0]);
+        return 1;
+    }
+
+    int compared = 0;
+    int skipped = 0;
+    long fired = 0;
+    long scanned = 0;
+    long dispatched = 0;
+
+    for (int seed = 1; seed <= seeds; seed++) {
+        long step_backs = StepBacks;
+        Examined = 0;
+        if (!Play((uint32_t)seed, frames, false)) {
+            StepBacks = step_backs;
+            skipped++;
+            continue;
+        }
+        scanned += Examined;
+
+        int count = LogCount;
+        Firing *expect = (Firing *)malloc((count ? count : 1) * sizeof(Firing));
+        if (expect == NULL) {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        memcpy(expect, Log, count * sizeof(Firing));
+
+        Examined = 0;
+        Play((uint32_t)seed, frames, true);
+        dispatched += Examined;
+
+        for (int index = 0; index < count || index < LogCount; index++) {
+            if (index >= count || index >= LogCount ||
+                expect[index].Frame != Log[index].Frame || expect[index].ID != Log[index].ID) {
+                fprintf(stderr, "seed %d: firing %d differs:", seed, index);
+                if (index < count) fprintf(stderr, " scan fired %d on frame %ld,", expect[index].ID, expect[index].Frame);
+                else fprintf(stderr, " scan fired nothing,");
+                if (index < LogCount) fprintf(stderr, " dispatcher fired %d on frame %ld\n", Log[index].ID, Log[index].Frame);
+                else fprintf(stderr, " dispatcher fired nothing\n");
+                return 1;
+            }
+        }
+        free(expect);
+
+        fired += count;
+        compared++;
+    }
+    free(Log);
+
+    printf("%d seeds of %d frames compared, %d skipped (scan stepped off the front)\n",
+           compared, frames, skipped);
+    printf("%ld firings matched, %ld deletions further down the list during the scan\n",
+           fired, StepBacks);
+    printf("triggers examined: scan %ld, dispatcher %ld (%.1f%%)\n",
+           scanned, dispatched, scanned ? 100.0 * dispatched / scanned : 0.0);
+
+    if (compared == 0) {
+        fprintf(stderr, "no seed could be compared\n");
+        return 1;
+    }
+    if (StepBacks == 0) {
+        fprintf(stderr, "no seed deleted a trigger further down the list during the scan\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,245 @@
+/*
+ * tests/udp_transport_test.c - loopback test for the batched UDP transport
+ *
+ * Opens several transports on the same base port, the way several copies of
+ * the game on one machine do; each ends up on its own port in the span. Every
+ * instance broadcasts a hello and collects the others' ports from the replies
+ * it receives. Then, for a number of rounds, every instance queues a burst of
+ * sequenced packets for every peer and flushes them, and every instance drains
+ * what arrived. Each packet must arrive intact, exactly once and in order, and
+ * the send and receive syscall counts must show that the packets were batched.
+ *
+ * usage: udp_transport_test [instances] [rounds] [base port]
+ */
+
+#define _GNU_SOURCE
+#include <ra/udp_transport.h>
+#include <arpa/inet.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_INSTANCES   UDP_PORT_SPAN
+/*
+ * Packets each instance receives per round, split between its peers. Loopback
+ * UDP drops what doesn't fit in the receive buffer (about 200 KB by default),
+ * so a round must fit in it.
+ */
+#define ROUND_PACKETS   120
+
+enum { HELLO = 1, DATA = 2 };
+
+typedef struct {
+    uint32_t kind;
+    uint32_t from;              /* Sender's port. */
+    uint32_t seq;
+    uint32_t length;            /* Bytes of payload that follow. */
+    unsigned char payload[200];
+} test_packet_t;
+
+static udp_transport_t net[MAX_INSTANCES];
+static unsigned short peers[MAX_INSTANCES][MAX_INSTANCES];
+static int npeers[MAX_INSTANCES];
+static uint32_t next_seq[MAX_INSTANCES][MAX_INSTANCES];     /* [to][from] */
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static unsigned char pattern(uint32_t from, uint32_t seq, uint32_t i)
+{
+    return (unsigned char)(from * 7 + seq * 13 + i);
+}
+
+static int index_of(int n, unsigned short port)
+{
+    for (int i = 0; i < n; i++) {
+        if (net[i].port == port) return i;
+    }
+    return -1;
+}
+
+/*
+ * Every instance broadcasts once, and every other instance must get that
+ * hello exactly once, whether the kernel looped the real broadcast back or
+ * refused it and the transport fell back to loopback. A real broadcast also
+ * comes back to its sender, which is ignored. Once every peer is found, the
+ * sockets are drained a little longer so that a late duplicate is caught.
+ */
+static int discover(int n)
+{
+    int hellos[MAX_INSTANCES][MAX_INSTANCES];     /* [to][from] */
+    memset(hellos, 0, sizeof(hellos));
+
+    for (int i = 0; i < n; i++) {
+        test_packet_t p;
+        memset(&p, 0, sizeof(p));
+        p.kind = HELLO;
+        p.from = net[i].port;
+        udp_transport_broadcast(&net[i], &p, sizeof(p));
+        udp_transport_flush(&net[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        double start = now_ms();
+        double found = -1.0;
+        while (found < 0.0 || now_ms() - found < 200.0) {
+            if (found < 0.0 && now_ms() - start > 2000.0) {
+                fprintf(stderr, "instance %d found %d of %d peers\n", i, npeers[i], n - 1);
+                return 1;
+            }
+            udp_transport_wait(&net[i], 50);
+            test_packet_t p;
+            struct sockaddr_in from;
+            while (udp_transport_receive(&net[i], &p, sizeof(p), &from) >= 0) {
+                unsigned short port = ntohs(from.sin_port);
+                int s = index_of(n, port);
+                if (p.kind != HELLO || p.from != port || s < 0 || s == i) continue;
+                if (hellos[i][s]++ == 0) peers[i][npeers[i]++] = port;
+            }
+            if (found < 0.0 && npeers[i] == n - 1) found = now_ms();
+        }
+        for (int s = 0; s < n; s++) {
+            if (s != i && hellos[i][s] != 1) {
+                fprintf(stderr, "instance %d got %d hellos from instance %d\n", i, hellos[i][s], s);
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static int receive_all(int i, int expect)
+{
+    int got = 0;
+    double start = now_ms();
+    while (got < expect) {
+        if (now_ms() - start > 2000.0) {
+            fprintf(stderr, "instance %d received %d of %d packets\n", i, got, expect);
+            return 1;
+        }
+        udp_transport_wait(&net[i], 100);
+        test_packet_t p;
+        struct sockaddr_in from;
+        int len;
+        while ((len = udp_transport_receive(&net[i], &p, sizeof(p), &from)) >= 0) {
+            if (p.kind == HELLO) continue;
+            int s = index_of(MAX_INSTANCES, ntohs(from.sin_port));
+            if (p.kind != DATA || s < 0 || p.from != net[s].port ||
+                len != (int)(offsetof(test_packet_t, payload) + p.length)) {
+                fprintf(stderr, "instance %d: bad packet from port %u\n", i, ntohs(from.sin_port));
+                return 1;
+            }
+            if (p.seq != next_seq[i][s]) {
+                fprintf(stderr, "instance %d: packet %u from %d, expected %u\n",
+                        i, p.seq, s, next_seq[i][s]);
+                return 1;
+            }
+            for (uint32_t b = 0; b < p.length; b++) {
+                if (p.payload[b] != pattern(p.from, p.seq, b)) {
+                    fprintf(stderr, "instance %d: packet %u from %d is corrupt\n", i, p.seq, s);
+                    return 1;
+                }
+            }
+            next_seq[i][s]++;
+            got++;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int n = argc > 1 ? atoi(argv[1]) : 4;
+    int rounds = argc > 2 ? atoi(argv[2]) : 50;
+    int base = argc > 3 ? atoi(argv[3]) : 0x5100;
+
+    if (n < 2 || n > MAX_INSTANCES || rounds <= 0 || base <= 0 || base + MAX_INSTANCES > 0xFFFF) {
+        fprintf(stderr, "usage: %s [instances 2-%d] [rounds] [base port]\n", argv[0], MAX_INSTANCES);
+        return 1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (udp_transport_open(&net[i], (unsigned short)base) != 0) {
+            fprintf(stderr, "instance %d: no free port in %d..%d\n", i, base, base + MAX_INSTANCES - 1);
+            return 1;
+        }
+        for (int k = 0; k < i; k++) {
+            if (net[k].port == net[i].port) {
+                fprintf(stderr, "instances %d and %d share port %u\n", k, i, net[i].port);
+                return 1;
+            }
+        }
+    }
+
+    if (discover(n)) return 1;
+
+    int burst = ROUND_PACKETS / (n - 1);
+    double start = now_ms();
+    for (int r = 0; r < rounds; r++) {
+        for (int i = 0; i < n; i++) {
+            for (int b = 0; b < burst; b++) {
+                for (int k = 0; k < npeers[i]; k++) {
+                    test_packet_t p;
+                    p.kind = DATA;
+                    p.from = net[i].port;
+                    p.seq = (uint32_t)(r * burst + b);
+                    p.length = (p.seq * 37) % sizeof(p.payload);
+                    for (uint32_t c = 0; c < p.length; c++) p.payload[c] = pattern(p.from, p.seq, c);
+
+                    struct sockaddr_in addr;
+                    memset(&addr, 0, sizeof(addr));
+                    addr.sin_family = AF_INET;
+                    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                    addr.sin_port = htons(peers[i][k]);
+                    if (udp_transport_send(&net[i], &p, (int)(offsetof(test_packet_t, payload) + p.length), &addr) != 0) {
+                        fprintf(stderr, "instance %d: send refused\n", i);
+                        return 1;
+                    }
+                }
+            }
+            udp_transport_flush(&net[i]);
+        }
+        for (int i = 0; i < n; i++) {
+            if (receive_all(i, burst * (n - 1))) return 1;
+        }
+    }
+    double ms = now_ms() - start;
+
+    unsigned long sent = 0, send_calls = 0, received = 0, recv_calls = 0, dropped = 0;
+    for (int i = 0; i < n; i++) {
+        sent += net[i].packets_out;
+        send_calls += net[i].send_calls;
+        received += net[i].packets_in;
+        recv_calls += net[i].recv_calls;
+        dropped += net[i].dropped;
+        udp_transport_close(&net[i]);
+    }
+
+    printf("%d instances on ports %d..%d, %d rounds of %d packets per peer\n",
+           n, base, base + n - 1, rounds, burst);
+    printf("sent     %8lu packets in %6lu sendmmsg calls (%5.1f per call)\n",
+           sent, send_calls, (double)sent / send_calls);
+    printf("received %8lu packets in %6lu recvmmsg calls (%5.1f per call)\n",
+           received, recv_calls, (double)received / recv_calls);
+    printf("dropped  %8lu (refused broadcasts)\n", dropped);
+    printf("%.2f ms, %.0f packets/s\n", ms, sent / (ms / 1000.0));
+
+    /*
+     * Each flush sends about ROUND_PACKETS packets, so it must carry close to
+     * a full pool. A refused broadcast costs an extra call, so allow for some.
+     */
+    if ((double)sent / send_calls < UDP_POOL_SIZE / 4) {
+        fprintf(stderr, "sends were not batched\n");
+        return 1;
+    }
+    if ((double)received / recv_calls < 4.0) {
+        fprintf(stderr, "receives were not batched\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,407 @@
+/*
+ * tests/vqa_decode_bench.c - headless benchmark for the VQA frame decode path
+ *
+ * Builds a synthetic movie (LCW-compressed vector pointers every frame and a
+ * new LCW-compressed codebook every GROUP frames), checks the UnVQ kernels in
+ * src/vq/unvq_decode.c against byte-at-a-time reference versions, then times
+ * decoding the movie serially against a loader thread that LCW-expands frames
+ * into a prefetch ring while the main thread UnVQs them, which is how the
+ * LVGL player runs with VQAConfig.LoaderThreads set.
+ *
+ * usage: vqa_decode_bench [frames] [depth] [width] [height]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include "unvq.h"
+
+#define GROUP    8   /* Frames per codebook. */
+#define CBCOUNT  256 /* Codebook entries; the pointers are one byte each. */
+
+unsigned long LCW_Uncompress(void *source, void *dest, unsigned long length);
+
+typedef void (*UnVQFunc)(unsigned char *, unsigned char *, unsigned char *,
+                         unsigned long, unsigned long, unsigned long);
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static uint32_t rng_state = 0x12345678;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* ---- Reference kernels: the original byte-at-a-time C versions ---- */
+
+static void ref_unvq(unsigned char *codebook, unsigned char *pointers,
+                     unsigned char *buffer, unsigned long blocksperrow,
+                     unsigned long numrows, unsigned long bufwidth,
+                     unsigned bw, unsigned bh)
+{
+    for (unsigned long r = 0; r < numrows; ++r) {
+        for (unsigned long c = 0; c < blocksperrow; ++c) {
+            const unsigned char *blk = codebook + pointers[r * blocksperrow + c] * bw * bh;
+            for (unsigned y = 0; y < bh; ++y)
+                for (unsigned x = 0; x < bw; ++x)
+                    buffer[(r * bh + y) * bufwidth + c * bw + x] = blk[y * bw + x];
+        }
+    }
+}
+
+static const struct {
+    const char *name;
+    UnVQFunc   func;
+    unsigned   bw, bh;
+} kernels[] = {
+    { "2x2", UnVQ_2x2, 2, 2 },
+    { "2x3", UnVQ_2x3, 2, 3 },
+    { "4x2", UnVQ_4x2, 4, 2 },
+    { "4x4", UnVQ_4x4, 4, 4 },
+};
+
+/* Run every kernel on random data with an image narrower than the buffer, so
+ * stores past a block row or past the image would show up in the margin. */
+static int check_kernels(void)
+{
+    enum { BPR = 37, ROWS = 23, PAD = 24 };
+    static unsigned char codebook[CBCOUNT * 16];
+    static unsigned char pointers[BPR * ROWS];
+    int bad = 0;
+
+    for (size_t i = 0; i < sizeof(codebook); i++) codebook[i] = (unsigned char)rng();
+    for (size_t i = 0; i < sizeof(pointers); i++) pointers[i] = (unsigned char)rng();
+
+    for (size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++) {
+        unsigned long width = BPR * kernels[k].bw + PAD;
+        size_t size = width * ROWS * kernels[k].bh;
+        unsigned char *want = malloc(size);
+        unsigned char *got = malloc(size);
+
+        memset(want, 0xA5, size);
+        memset(got, 0xA5, size);
+        ref_unvq(codebook, pointers, want, BPR, ROWS, width, kernels[k].bw, kernels[k].bh);
+        kernels[k].func(codebook, pointers, got, BPR, ROWS, width);
+
+        if (memcmp(want, got, size) != 0) {
+            fprintf(stderr, "UnVQ_%s does not match the reference\n", kernels[k].name);
+            bad = 1;
+        }
+        free(want);
+        free(got);
+    }
+    return bad;
+}
+
+/* ---- Synthetic movie ---- */
+
+/* Minimal LCW encoder: fills (0xFE), copies of the row above (0xC0/0xFF,
+ * absolute offsets) and literal runs, enough to give LCW_Uncompress the mix of
+ * commands it sees in real pointer data. */
+static size_t lcw_encode(const unsigned char *src, size_t len, size_t rowlen, unsigned char *out)
+{
+    unsigned char *dst = out;
+    unsigned char *lit = NULL;
+    size_t i = 0;
+
+    while (i < len) {
+        size_t run = 1;
+        size_t match = 0;
+
+        while (i + run < len && run < 0xFFFF && src[i + run] == src[i]) run++;
+        if (i >= rowlen && i - rowlen <= 0xFFFF) {
+            while (i + match < len && match < 0xFFFF && src[i + match] == src[i - rowlen + match]) match++;
+        }
+
+        if (run >= 4 && run >= match) {
+            *dst++ = 0xFE;
+            *dst++ = (unsigned char)run;
+            *dst++ = (unsigned char)(run >> 8);
+            *dst++ = src[i];
+            i += run;
+            lit = NULL;
+        } else if (match >= 3) {
+            size_t off = i - rowlen;
+            if (match <= 64) {
+                *dst++ = (unsigned char)(0xC0 | (match - 3));
+            } else {
+                *dst++ = 0xFF;
+                *dst++ = (unsigned char)match;
+                *dst++ = (unsigned char)(match >> 8);
+            }
+            *dst++ = (unsigned char)off;
+            *dst++ = (unsigned char)(off >> 8);
+            i += match;
+            lit = NULL;
+        } else {
+            if (lit == NULL || *lit == 0xBF) {
+                lit = dst++;
+                *lit = 0x80;
+            }
+            (*lit)++;
+            *dst++ = src[i++];
+        }
+    }
+    *dst++ = 0x80;
+    return (size_t)(dst - out);
+}
+
+typedef struct {
+    unsigned char *cbz;  /* Compressed codebook, or NULL if the group's is reused. */
+    unsigned char *ptrz; /* Compressed vector pointers. */
+} BenchFrame;
+
+typedef struct {
+    int           frames;
+    unsigned long bpr, rows, width;
+    size_t        cbsize, ptrsize, imgsize;
+    size_t        packed;
+    BenchFrame    *frame;
+} Movie;
+
+static void make_movie(Movie *m, int frames, unsigned long width, unsigned long height)
+{
+    unsigned char *cb, *ptr, *tmp;
+    size_t total = 0;
+
+    m->frames = frames;
+    m->bpr = width / 4;
+    m->rows = height / 2;
+    m->width = m->bpr * 4;
+    m->cbsize = CBCOUNT * 8;
+    m->ptrsize = m->bpr * m->rows;
+    m->imgsize = m->width * m->rows * 2;
+    m->frame = calloc(frames, sizeof(BenchFrame));
+
+    cb = malloc(m->cbsize);
+    ptr = malloc(m->ptrsize);
+    tmp = malloc(m->ptrsize * 2 + m->cbsize * 2 + 16);
+
+    /* Large flat regions that drift every few frames, plus a sprinkling of
+     * per-frame changes; rows repeat often, as they do in real movies. */
+    for (int f = 0; f < frames; f++) {
+        size_t n;
+
+        if ((f % GROUP) == 0) {
+            for (size_t i = 0; i < m->cbsize; i++) cb[i] = (unsigned char)(rng() >> 8);
+            n = lcw_encode(cb, m->cbsize, 8, tmp);
+            m->frame[f].cbz = malloc(n);
+            memcpy(m->frame[f].cbz, tmp, n);
+            total += n;
+        }
+
+        for (unsigned long y = 0; y < m->rows; y++) {
+            for (unsigned long x = 0; x < m->bpr; x++) {
+                unsigned region = (unsigned)(((x + f / 4) / 6) * 31 + (y / 5) * 17);
+                ptr[y * m->bpr + x] = (unsigned char)(region * 2654435761u >> 24);
+            }
+        }
+        for (size_t i = 0; i < m->ptrsize / 16; i++) {
+            ptr[rng() % m->ptrsize] = (unsigned char)rng();
+        }
+
+        n = lcw_encode(ptr, m->ptrsize, m->bpr, tmp);
+        m->frame[f].ptrz = malloc(n);
+        memcpy(m->frame[f].ptrz, tmp, n);
+        total += n;
+    }
+    m->packed = total;
+    free(cb);
+    free(ptr);
+    free(tmp);
+}
+
+static void free_movie(Movie *m)
+{
+    for (int f = 0; f < m->frames; f++) {
+        free(m->frame[f].cbz);
+        free(m->frame[f].ptrz);
+    }
+    free(m->frame);
+}
+
+/* Stand-in for handing the image to the display: fold it into a checksum. */
+static uint32_t present(const unsigned char *img, size_t size, uint32_t sum)
+{
+    for (size_t i = 0; i < size; i += 64) sum = (sum ^ img[i]) * 16777619u;
+    return sum;
+}
+
+/* ---- Serial decode: expand and draw each frame in turn ---- */
+
+static uint32_t decode_serial(const Movie *m, UnVQFunc unvq, double *ms)
+{
+    unsigned char *cb = malloc(m->cbsize + 16);
+    unsigned char *ptr = malloc(m->ptrsize + 16);
+    unsigned char *img = malloc(m->imgsize);
+    uint32_t sum = 2166136261u;
+    double t0 = now_ms();
+
+    for (int f = 0; f < m->frames; f++) {
+        if (m->frame[f].cbz) LCW_Uncompress(m->frame[f].cbz, cb, m->cbsize);
+        LCW_Uncompress(m->frame[f].ptrz, ptr, m->ptrsize);
+        unvq(cb, ptr, img, m->bpr, m->rows, m->width);
+        sum = present(img, m->imgsize, sum);
+    }
+
+    *ms = now_ms() - t0;
+    free(cb);
+    free(ptr);
+    free(img);
+    return sum;
+}
+
+/* ---- Prefetched decode: a loader thread expands frames into a ring ---- */
+
+typedef struct {
+    unsigned char *ptr;
+    int           cb;    /* Codebook ring slot used by this frame. */
+    int           ready;
+} Slot;
+
+typedef struct {
+    const Movie     *movie;
+    Slot            *slot;
+    unsigned char   **cb;
+    int             depth;
+    int             numcb;
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+} Ring;
+
+static void *loader_thread(void *arg)
+{
+    Ring *ring = arg;
+    const Movie *m = ring->movie;
+    int cb = -1;
+
+    for (int f = 0; f < m->frames; f++) {
+        Slot *slot = &ring->slot[f % ring->depth];
+
+        pthread_mutex_lock(&ring->lock);
+        while (slot->ready) pthread_cond_wait(&ring->cond, &ring->lock);
+        pthread_mutex_unlock(&ring->lock);
+
+        if (m->frame[f].cbz) {
+            cb = (cb + 1) % ring->numcb;
+            LCW_Uncompress(m->frame[f].cbz, ring->cb[cb], m->cbsize);
+        }
+        LCW_Uncompress(m->frame[f].ptrz, slot->ptr, m->ptrsize);
+        slot->cb = cb;
+
+        pthread_mutex_lock(&ring->lock);
+        slot->ready = 1;
+        pthread_cond_broadcast(&ring->cond);
+        pthread_mutex_unlock(&ring->lock);
+    }
+    return NULL;
+}
+
+static uint32_t decode_prefetch(const Movie *m, UnVQFunc unvq, int depth, double *ms)
+{
+    Ring ring;
+    pthread_t thread;
+    unsigned char *img = malloc(m->imgsize);
+    uint32_t sum = 2166136261u;
+    double t0;
+
+    /* Enough codebooks that the loader never overwrites one still in use:
+     * up to depth frames ahead can span depth / GROUP + 1 new codebooks. */
+    ring.movie = m;
+    ring.depth = depth;
+    ring.numcb = depth / GROUP + 2;
+    ring.slot = calloc(depth, sizeof(Slot));
+    ring.cb = calloc(ring.numcb, sizeof(unsigned char *));
+    for (int i = 0; i < depth; i++) ring.slot[i].ptr = malloc(m->ptrsize + 16);
+    for (int i = 0; i < ring.numcb; i++) ring.cb[i] = malloc(m->cbsize + 16);
+    pthread_mutex_init(&ring.lock, NULL);
+    pthread_cond_init(&ring.cond, NULL);
+
+    t0 = now_ms();
+    pthread_create(&thread, NULL, loader_thread, &ring);
+
+    for (int f = 0; f < m->frames; f++) {
+        Slot *slot = &ring.slot[f % depth];
+
+        pthread_mutex_lock(&ring.lock);
+        while (!slot->ready) pthread_cond_wait(&ring.cond, &ring.lock);
+        pthread_mutex_unlock(&ring.lock);
+
+        unvq(ring.cb[slot->cb], slot->ptr, img, m->bpr, m->rows, m->width);
+        sum = present(img, m->imgsize, sum);
+
+        pthread_mutex_lock(&ring.lock);
+        slot->ready = 0;
+        pthread_cond_broadcast(&ring.cond);
+        pthread_mutex_unlock(&ring.lock);
+    }
+
+    pthread_join(thread, NULL);
+    *ms = now_ms() - t0;
+
+    pthread_cond_destroy(&ring.cond);
+    pthread_mutex_destroy(&ring.lock);
+    for (int i = 0; i < depth; i++) free(ring.slot[i].ptr);
+    for (int i = 0; i < ring.numcb; i++) free(ring.cb[i]);
+    free(ring.slot);
+    free(ring.cb);
+    free(img);
+    return sum;
+}
+
+static void ref_unvq_4x2(unsigned char *codebook, unsigned char *pointers,
+                         unsigned char *buffer, unsigned long blocksperrow,
+                         unsigned long numrows, unsigned long bufwidth)
+{
+    ref_unvq(codebook, pointers, buffer, blocksperrow, numrows, bufwidth, 4, 2);
+}
+
+int main(int argc, char **argv)
+{
+    int frames = argc > 1 ? atoi(argv[1]) : 2000;
+    int depth = argc > 2 ? atoi(argv[2]) : 4;
+    unsigned long width = argc > 3 ? strtoul(argv[3], NULL, 10) : 320;
+    unsigned long height = argc > 4 ? strtoul(argv[4], NULL, 10) : 200;
+    Movie movie;
+    double ref_ms, serial_ms, prefetch_ms;
+    uint32_t ref_sum, serial_sum, prefetch_sum;
+
+    if (frames < 1 || depth < 1 || width < 4 || height < 2) {
+        fprintf(stderr, "usage: %s [frames] [depth] [width] [height]\n", argv[0]);
+        return 2;
+    }
+
+    if (check_kernels()) return 1;
+
+    make_movie(&movie, frames, width, height);
+    printf("%d frames %lux%lu (4x2 blocks), %.1f KB compressed\n",
+           frames, movie.width, movie.rows * 2, movie.packed / 1024.0);
+
+    ref_sum = decode_serial(&movie, ref_unvq_4x2, &ref_ms);
+    serial_sum = decode_serial(&movie, UnVQ_4x2, &serial_ms);
+    prefetch_sum = decode_prefetch(&movie, UnVQ_4x2, depth, &prefetch_ms);
+    free_movie(&movie);
+
+    printf("serial, reference UnVQ: %9.2f ms  %8.1f fps\n", ref_ms, frames * 1000.0 / ref_ms);
+    printf("serial:                 %9.2f ms  %8.1f fps\n", serial_ms, frames * 1000.0 / serial_ms);
+    printf("prefetch depth %-3d:     %9.2f ms  %8.1f fps\n", depth, prefetch_ms, frames * 1000.0 / prefetch_ms);
+
+    if (serial_sum != ref_sum || prefetch_sum != ref_sum) {
+        fprintf(stderr, "decoded frames differ: ref %08x serial %08x prefetch %08x\n",
+                ref_sum, serial_sum, prefetch_sum);
+        return 1;
+    }
+    return 0;
+}
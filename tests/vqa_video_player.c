@@ -7,7 +7,7 @@
 #include <unistd.h>
 #include "../src/lvgl/src/lvgl.h"
 
-int main(void) {
+int main(int argc, char **argv) {
     lv_init();
     ScreenWidth = 320;
     ScreenHeight = 240;
@@ -33,6 +33,8 @@ int main(void) {
     cfg.ImageHeight = 240;
     cfg.OptionFlags = 0;
     cfg.DrawFlags |= VQACFGF_BUFFER;
+    if(argc > 1) cfg.LoaderThreads = atol(argv[1]);
+    if(argc > 2) cfg.PrefetchDepth = atol(argv[2]);
 
     while(1) {
         for(int i=0;i<num;i++) {